@@ -0,0 +1,665 @@
+#include <SimpleMemoryAllocator.h>
+#include <BenchmarkHarness.h>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+
+using namespace SimpleMemoryAllocator;
+
+const size_t ALIGNMENT = alignof(std::max_align_t);   // the alignment malloc guarantees, requested from all allocators
+const size_t SEQUENCE_LENGTH = 1 << 16;                 // length of the pre-generated random operation sequences
+const size_t OBJECT_SIZE = 64;                          // object size of the fixed size workloads
+const size_t ARENA_SIZE = 64 * 1024 * 1024;             // memory given to the general purpose allocators
+
+///////////////////////
+// ALLOCATOR TARGETS //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// thin facades giving all allocators the same interface, so that every workload is a single template
+
+struct MallocTarget {
+	static const bool RESETTABLE = false;
+	void* allocate(size_t size) { return std::malloc(size); }
+	void deallocate(void* ptr) { std::free(ptr); }
+	void reset() { }
+};
+
+struct NewTarget {
+	static const bool RESETTABLE = false;
+	void* allocate(size_t size) { return ::operator new(size); }
+	void deallocate(void* ptr) { ::operator delete(ptr); }
+	void reset() { }
+};
+
+template <class Allocator> struct RawTarget {
+	static const bool RESETTABLE = false;
+	Allocator& allocator;
+	void* allocate(size_t size) { return allocator.allocate_raw(size, ALIGNMENT); }
+	void deallocate(void* ptr) { allocator.deallocate_raw(ptr); }
+	void reset() { }
+};
+
+template <class Allocator> struct LockedTarget {
+	static const bool RESETTABLE = false;
+	Allocator& allocator;
+	void* allocate(size_t size) { return allocator.allocate_raw_thread_safe(size, ALIGNMENT); }
+	void deallocate(void* ptr) { allocator.deallocate_raw_thread_safe(ptr); }
+	void reset() { }
+};
+
+template <class Allocator> struct LinearTarget {
+	static const bool RESETTABLE = true;
+	Allocator& allocator;
+	void* allocate(size_t size) { return allocator.allocate_raw(size, ALIGNMENT); }
+	void deallocate(void* ptr) { }
+	void reset() { allocator.clear(); }
+};
+
+template <class Allocator> struct LockedLinearTarget {
+	static const bool RESETTABLE = true;
+	Allocator& allocator;
+	void* allocate(size_t size) { return allocator.allocate_raw_thread_safe(size, ALIGNMENT); }
+	void deallocate(void* ptr) { }
+	void reset() { allocator.clear(); }
+};
+
+struct FrameTarget {
+	static const bool RESETTABLE = true;
+	FrameAllocator& allocator;
+	void* allocate(size_t size) { return allocator.allocate_raw(size, ALIGNMENT); }
+	void deallocate(void* ptr) { }
+	void reset() { allocator.begin_frame(); }
+};
+
+struct ThreadCacheTarget {
+	static const bool RESETTABLE = false;
+	ThreadCache& cache;
+	void* allocate(size_t size) { return cache.allocate_block(); }
+	void deallocate(void* ptr) { cache.deallocate_block(ptr); }
+	void reset() { }
+};
+
+// a buffer owned by a single thread, the benchmarks give every thread a target of its own
+struct ThreadBufferTarget {
+	static const bool RESETTABLE = true;
+	ConcurrentLinearAllocator& allocator;
+	std::unique_ptr<ConcurrentLinearAllocator::ThreadBuffer> buffer;
+	void* allocate(size_t size) { return buffer->allocate_raw(size, ALIGNMENT); }
+	void deallocate(void* ptr) { }
+	void reset() { allocator.clear(); }
+};
+
+struct PerCpuCacheTarget {
+	static const bool RESETTABLE = false;
+	PerCpuCache& cache;
+	void* allocate(size_t size) { return cache.allocate_raw(size, ALIGNMENT); }
+	void deallocate(void* ptr) { cache.deallocate_raw(ptr); }
+	void reset() { }
+};
+
+struct RemoteFreeTarget {
+	static const bool RESETTABLE = false;
+	RemoteFreePoolAllocator& pool;
+	void* allocate(size_t size) {
+		// the harness starts new threads in every repetition, the producer takes the pool over
+		if (!pool.is_owner_thread())
+			pool.set_owner_thread();
+		return pool.allocate_raw(size, ALIGNMENT);
+	}
+	void deallocate(void* ptr) { pool.deallocate_raw(ptr); }
+	void reset() { }
+};
+
+///////////////////////
+// OPERATION SOURCES //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// the same block size every time
+std::vector<size_t> make_fixed_sizes(size_t size) {
+	return std::vector<size_t>(SEQUENCE_LENGTH, size);
+}
+
+// log-uniformly distributed block sizes, small blocks being as common as large ones in every doubling
+std::vector<size_t> make_mixed_sizes(size_t min_size, size_t max_size, unsigned seed) {
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<double> exponent(std::log2((double)min_size), std::log2((double)max_size));
+
+	std::vector<size_t> sizes(SEQUENCE_LENGTH);
+	for (size_t& size : sizes)
+		size = (size_t)std::exp2(exponent(generator));
+
+	return sizes;
+}
+
+// slots of the live object window replaced by the churn workloads
+std::vector<uint32_t> make_slots(size_t window, unsigned seed) {
+	std::mt19937 generator(seed);
+
+	std::vector<uint32_t> slots(SEQUENCE_LENGTH);
+	for (uint32_t& slot : slots)
+		slot = (uint32_t)(generator() % window);
+
+	return slots;
+}
+
+///////////////
+// WORKLOADS //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// keeps a window of live blocks per thread and replaces a random one in every operation, the typical
+// life cycle of objects that outlive a few others but not the whole program
+template <class Target> class ChurnWorkload {
+private:
+	struct alignas(64) ThreadState {
+		std::vector<void*>  live;
+		size_t              cursor;
+	};
+
+	Target&                     m_target;
+	const std::vector<size_t>&  m_sizes;
+	const std::vector<uint32_t>& m_slots;
+	std::vector<ThreadState>    m_threads;
+	size_t                      m_opsPerBatch;
+
+public:
+	ChurnWorkload(Target& target, const std::vector<size_t>& sizes, const std::vector<uint32_t>& slots, size_t window, size_t threads, size_t ops_per_batch)
+		: m_target(target), m_sizes(sizes), m_slots(slots), m_threads(threads), m_opsPerBatch(ops_per_batch) {
+		for (size_t i = 0; i < threads; ++i) {
+			m_threads[i].live.assign(window, nullptr);
+			m_threads[i].cursor = i * (SEQUENCE_LENGTH / threads);
+		}
+	}
+
+	size_t ops_per_batch() const { return m_opsPerBatch; }
+
+	void begin_repetition() { }
+
+	void run_batch(size_t thread) {
+		ThreadState& state = m_threads[thread];
+
+		for (size_t i = 0; i < m_opsPerBatch; ++i) {
+			size_t op = state.cursor++ & (SEQUENCE_LENGTH - 1);
+			void*& slot = state.live[m_slots[op]];
+
+			if (slot != nullptr)
+				m_target.deallocate(slot);
+
+			slot = m_target.allocate(m_sizes[op]);
+			if (slot != nullptr)
+				*(char*)slot = (char)op;
+			Benchmark::do_not_optimize(slot);
+		}
+	}
+
+	void end_repetition() {
+		for (ThreadState& state : m_threads) {
+			for (void*& slot : state.live) {
+				if (slot != nullptr)
+					m_target.deallocate(slot);
+				slot = nullptr;
+			}
+		}
+	}
+};
+
+// allocates a nested group of blocks and frees them in reverse order, like a recursive algorithm would
+template <class Target> class LifoWorkload {
+private:
+	static const size_t DEPTH = 64;
+	static const size_t ROUNDS = 16;
+
+	Target&                     m_target;
+	const std::vector<size_t>&  m_sizes;
+	size_t                      m_cursor;
+
+public:
+	LifoWorkload(Target& target, const std::vector<size_t>& sizes) : m_target(target), m_sizes(sizes), m_cursor(0) { }
+
+	size_t ops_per_batch() const { return DEPTH * ROUNDS; }
+
+	void begin_repetition() { }
+
+	void run_batch(size_t thread) {
+		void* blocks[DEPTH];
+
+		for (size_t round = 0; round < ROUNDS; ++round) {
+			for (size_t i = 0; i < DEPTH; ++i) {
+				size_t op = m_cursor++ & (SEQUENCE_LENGTH - 1);
+				blocks[i] = m_target.allocate(m_sizes[op]);
+				if (blocks[i] != nullptr)
+					*(char*)blocks[i] = (char)op;
+				Benchmark::do_not_optimize(blocks[i]);
+			}
+
+			for (size_t i = DEPTH; i-- > 0;)
+				if (blocks[i] != nullptr)
+					m_target.deallocate(blocks[i]);
+		}
+	}
+
+	void end_repetition() { }
+};
+
+// every batch is a single frame allocating lots of short-lived blocks which all die at the end of it,
+// released at once by allocators able to do so and one by one (newest first) by the rest
+template <class Target> class FrameWorkload {
+private:
+	static const size_t BLOCKS_PER_FRAME = 1024;
+
+	Target&                     m_target;
+	const std::vector<size_t>&  m_sizes;
+	size_t                      m_cursor;
+	std::vector<void*>          m_blocks;
+
+public:
+	FrameWorkload(Target& target, const std::vector<size_t>& sizes) : m_target(target), m_sizes(sizes), m_cursor(0), m_blocks(BLOCKS_PER_FRAME) { }
+
+	size_t ops_per_batch() const { return BLOCKS_PER_FRAME; }
+
+	void begin_repetition() { }
+
+	void run_batch(size_t thread) {
+		for (size_t i = 0; i < BLOCKS_PER_FRAME; ++i) {
+			size_t op = m_cursor++ & (SEQUENCE_LENGTH - 1);
+			m_blocks[i] = m_target.allocate(m_sizes[op]);
+			if (m_blocks[i] != nullptr)
+				std::memset(m_blocks[i], 0, m_sizes[op]);
+			Benchmark::do_not_optimize(m_blocks[i]);
+		}
+
+		if (Target::RESETTABLE) {
+			m_target.reset();
+		} else {
+			for (size_t i = BLOCKS_PER_FRAME; i-- > 0;)
+				if (m_blocks[i] != nullptr)
+					m_target.deallocate(m_blocks[i]);
+		}
+	}
+
+	void end_repetition() { }
+};
+
+// several threads filling the memory with short-lived blocks at the same time, all of which die together
+// at the end of the repetition; every thread works through a target of its own, so that per-thread state
+// (e.g. a thread buffer) can live in the target, while shared allocators are referenced by all of them
+template <class Target> class FillWorkload {
+private:
+	static const size_t BLOCKS_PER_BATCH = 1024;
+
+	struct alignas(64) ThreadState {
+		Target              target;
+		size_t              cursor;
+		std::vector<void*>  blocks;     // blocks to free one by one, unused by resettable targets
+	};
+
+	const std::vector<size_t>&  m_sizes;
+	std::vector<ThreadState>    m_threads;
+
+public:
+	template <class MakeTarget> FillWorkload(MakeTarget make_target, const std::vector<size_t>& sizes, size_t threads) : m_sizes(sizes) {
+		m_threads.reserve(threads);
+		for (size_t i = 0; i < threads; ++i)
+			m_threads.push_back(ThreadState{make_target(), i * (SEQUENCE_LENGTH / threads), std::vector<void*>()});
+	}
+
+	size_t ops_per_batch() const { return BLOCKS_PER_BATCH; }
+
+	void begin_repetition() { }
+
+	void run_batch(size_t thread) {
+		ThreadState& state = m_threads[thread];
+
+		for (size_t i = 0; i < BLOCKS_PER_BATCH; ++i) {
+			size_t op = state.cursor++ & (SEQUENCE_LENGTH - 1);
+			void* ptr = state.target.allocate(m_sizes[op]);
+			if (ptr != nullptr) {
+				std::memset(ptr, 0, m_sizes[op]);
+				if (!Target::RESETTABLE)
+					state.blocks.push_back(ptr);
+			}
+			Benchmark::do_not_optimize(ptr);
+		}
+	}
+
+	void end_repetition() {
+		if (Target::RESETTABLE) {
+			m_threads[0].target.reset();
+		} else {
+			for (ThreadState& state : m_threads) {
+				for (void* ptr : state.blocks)
+					state.target.deallocate(ptr);
+				state.blocks.clear();
+			}
+		}
+	}
+};
+
+// pairs of threads, the even thread of every pair allocates fixed-size blocks and hands them over a bounded
+// queue to the odd one, which deallocates them; every pair works through a target of its own, so that an
+// allocator owned by a single producer can be given to every pair
+template <class Target> class ProducerConsumerWorkload {
+private:
+	static const size_t BLOCKS_PER_BATCH = 1024;
+	static const size_t QUEUE_SIZE = 256;
+
+	// a single-producer single-consumer ring of blocks in flight
+	struct Pair {
+		Target                          target;
+		alignas(64) std::atomic<size_t> head;       // the next block the consumer takes
+		alignas(64) std::atomic<size_t> tail;       // the next free slot of the producer
+		void*                           queue[QUEUE_SIZE];
+
+		explicit Pair(Target&& t) : target(std::move(t)), head(0), tail(0) { }
+	};
+
+	std::vector<std::unique_ptr<Pair>>  m_pairs;
+
+public:
+	template <class MakeTarget> ProducerConsumerWorkload(MakeTarget make_target, size_t threads) {
+		for (size_t i = 0; i < threads / 2; ++i)
+			m_pairs.emplace_back(new Pair(make_target(i)));
+	}
+
+	size_t ops_per_batch() const { return BLOCKS_PER_BATCH; }
+
+	void begin_repetition() { }
+
+	void run_batch(size_t thread) {
+		Pair& pair = *m_pairs[thread / 2];
+
+		if (thread % 2 == 0) {
+			for (size_t i = 0; i < BLOCKS_PER_BATCH; ++i) {
+				// the blocks in flight come back once the consumer catches up
+				void* ptr;
+				while ((ptr = pair.target.allocate(OBJECT_SIZE)) == nullptr)
+					std::this_thread::yield();
+				*(char*)ptr = (char)i;
+
+				size_t tail = pair.tail.load(std::memory_order_relaxed);
+				while (tail - pair.head.load(std::memory_order_acquire) == QUEUE_SIZE)
+					std::this_thread::yield();
+				pair.queue[tail % QUEUE_SIZE] = ptr;
+				pair.tail.store(tail + 1, std::memory_order_release);
+			}
+		} else {
+			for (size_t i = 0; i < BLOCKS_PER_BATCH; ++i) {
+				size_t head = pair.head.load(std::memory_order_relaxed);
+				while (pair.tail.load(std::memory_order_acquire) == head)
+					std::this_thread::yield();
+				void* ptr = pair.queue[head % QUEUE_SIZE];
+				pair.head.store(head + 1, std::memory_order_release);
+
+				Benchmark::do_not_optimize(ptr);
+				pair.target.deallocate(ptr);
+			}
+		}
+	}
+
+	void end_repetition() { }
+};
+
+////////////////
+// BENCHMARKS //
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class Suite {
+private:
+	const Benchmark::Config&    m_config;
+	Benchmark::Reporter         m_reporter;
+
+public:
+	Suite(const Benchmark::Config& config) : m_config(config), m_reporter(config.format) { }
+
+	void begin() { m_reporter.begin(); }
+	void end() { m_reporter.end(); }
+
+	bool is_selected(const char* workload, const char* allocator) const {
+		return Benchmark::is_selected(m_config, workload, allocator);
+	}
+
+	template <class Workload> void run(const char* workload, const char* allocator, Workload&& w, size_t threads = 1) {
+		m_reporter.report(Benchmark::run(m_config, workload, allocator, w, threads));
+	}
+
+	template <class Target> void churn(const char* workload, const char* allocator, Target&& target, const std::vector<size_t>& sizes, const std::vector<uint32_t>& slots, size_t window, size_t threads = 1) {
+		if (is_selected(workload, allocator))
+			run(workload, allocator, ChurnWorkload<Target>(target, sizes, slots, window, threads, 1024), threads);
+	}
+
+	template <class Target> void lifo(const char* allocator, Target&& target, const std::vector<size_t>& sizes) {
+		if (is_selected("lifo", allocator))
+			run("lifo", allocator, LifoWorkload<Target>(target, sizes));
+	}
+
+	template <class Target> void frame(const char* allocator, Target&& target, const std::vector<size_t>& sizes) {
+		if (is_selected("frame_reset", allocator))
+			run("frame_reset", allocator, FrameWorkload<Target>(target, sizes));
+	}
+
+	template <class MakeTarget> void fill(const char* allocator, MakeTarget make_target, const std::vector<size_t>& sizes, size_t threads) {
+		if (is_selected("parallel_fill", allocator))
+			run("parallel_fill", allocator, FillWorkload<decltype(make_target())>(make_target, sizes, threads), threads);
+	}
+
+	template <class MakeTarget> void producer_consumer(const char* allocator, MakeTarget make_target, size_t threads) {
+		if (is_selected("prod_consumer", allocator))
+			run("prod_consumer", allocator, ProducerConsumerWorkload<decltype(make_target(0))>(make_target, threads), threads);
+	}
+};
+
+// the same fixed-size objects allocated and freed in random order
+void run_fixed_churn(Suite& suite) {
+	const size_t window = 1024;
+	const std::vector<size_t> sizes = make_fixed_sizes(OBJECT_SIZE);
+	const std::vector<uint32_t> slots = make_slots(window, 1);
+
+	PoolAllocator pool(window * OBJECT_SIZE + ALIGNMENT, OBJECT_SIZE, ALIGNMENT);
+	ConcurrentPoolAllocator concurrentPool(window * OBJECT_SIZE + ALIGNMENT, OBJECT_SIZE, ALIGNMENT);
+	StaticPoolAllocator staticPool(window * OBJECT_SIZE + ALIGNMENT, OBJECT_SIZE, ALIGNMENT);
+	BitmapPoolAllocator bitmapPool(window * (OBJECT_SIZE + 1) + 64, OBJECT_SIZE, ALIGNMENT);
+	SlabAllocator slab(ARENA_SIZE);
+	FreeListAllocator freeList(ARENA_SIZE);
+	BuddyAllocator buddy(ARENA_SIZE, 6, 22);
+
+	suite.churn("fixed_churn", "PoolAllocator", RawTarget<PoolAllocator>{pool}, sizes, slots, window);
+	suite.churn("fixed_churn", "StaticPoolAllocator", RawTarget<StaticPoolAllocator>{staticPool}, sizes, slots, window);
+	suite.churn("fixed_churn", "BitmapPoolAllocator", RawTarget<BitmapPoolAllocator>{bitmapPool}, sizes, slots, window);
+	suite.churn("fixed_churn", "ConcurrentPoolAllocator", RawTarget<ConcurrentPoolAllocator>{concurrentPool}, sizes, slots, window);
+	suite.churn("fixed_churn", "SlabAllocator", RawTarget<SlabAllocator>{slab}, sizes, slots, window);
+	suite.churn("fixed_churn", "FreeListAllocator", RawTarget<FreeListAllocator>{freeList}, sizes, slots, window);
+	suite.churn("fixed_churn", "BuddyAllocator", RawTarget<BuddyAllocator>{buddy}, sizes, slots, window);
+	suite.churn("fixed_churn", "malloc", MallocTarget(), sizes, slots, window);
+	suite.churn("fixed_churn", "new", NewTarget(), sizes, slots, window);
+}
+
+// variable sized blocks between 8 bytes and 2 KiB allocated and freed in random order
+void run_mixed_churn(Suite& suite) {
+	const size_t window = 1024;
+	const std::vector<size_t> sizes = make_mixed_sizes(8, 2048, 2);
+	const std::vector<uint32_t> slots = make_slots(window, 3);
+
+	FreeListAllocator firstFit(ARENA_SIZE, FreeListAllocator::FIRST_FIT);
+	FreeListAllocator bestFit(ARENA_SIZE, FreeListAllocator::BEST_FIT);
+	FreeListAllocator segregatedFit(ARENA_SIZE, FreeListAllocator::SEGREGATED_FIT);
+	SlabAllocator slab(ARENA_SIZE);
+	BuddyAllocator buddy(ARENA_SIZE, 4, 22);
+
+	suite.churn("mixed_churn", "FreeListAllocator/first", RawTarget<FreeListAllocator>{firstFit}, sizes, slots, window);
+	suite.churn("mixed_churn", "FreeListAllocator/best", RawTarget<FreeListAllocator>{bestFit}, sizes, slots, window);
+	suite.churn("mixed_churn", "FreeListAllocator/seg", RawTarget<FreeListAllocator>{segregatedFit}, sizes, slots, window);
+	suite.churn("mixed_churn", "SlabAllocator", RawTarget<SlabAllocator>{slab}, sizes, slots, window);
+	suite.churn("mixed_churn", "BuddyAllocator", RawTarget<BuddyAllocator>{buddy}, sizes, slots, window);
+	suite.churn("mixed_churn", "malloc", MallocTarget(), sizes, slots, window);
+	suite.churn("mixed_churn", "new", NewTarget(), sizes, slots, window);
+}
+
+// nested blocks between 8 and 512 bytes freed in reverse order
+void run_lifo(Suite& suite) {
+	const std::vector<size_t> sizes = make_mixed_sizes(8, 512, 4);
+
+	StackAllocator stack(ARENA_SIZE);
+	StaticStackAllocator staticStack(ARENA_SIZE);
+	FreeListAllocator freeList(ARENA_SIZE);
+
+	suite.lifo("StackAllocator", RawTarget<StackAllocator>{stack}, sizes);
+	suite.lifo("StaticStackAllocator", RawTarget<StaticStackAllocator>{staticStack}, sizes);
+	suite.lifo("FreeListAllocator", RawTarget<FreeListAllocator>{freeList}, sizes);
+	suite.lifo("malloc", MallocTarget(), sizes);
+	suite.lifo("new", NewTarget(), sizes);
+}
+
+// short-lived blocks between 8 and 256 bytes all released at the end of every frame
+void run_frame_reset(Suite& suite) {
+	const std::vector<size_t> sizes = make_mixed_sizes(8, 256, 5);
+
+	LinearAllocator linear(ARENA_SIZE);
+	LinearAllocator growableLinear(64 * 1024, ARENA_SIZE);
+	StaticLinearAllocator staticLinear(ARENA_SIZE);
+	StackAllocator stack(ARENA_SIZE);
+	FrameAllocator frames(ARENA_SIZE / 2, 2);
+
+	suite.frame("LinearAllocator", LinearTarget<LinearAllocator>{linear}, sizes);
+	suite.frame("LinearAllocator/grow", LinearTarget<LinearAllocator>{growableLinear}, sizes);
+	suite.frame("StaticLinearAllocator", LinearTarget<StaticLinearAllocator>{staticLinear}, sizes);
+	suite.frame("FrameAllocator", FrameTarget{frames}, sizes);
+	suite.frame("StackAllocator", RawTarget<StackAllocator>{stack}, sizes);
+	suite.frame("malloc", MallocTarget(), sizes);
+	suite.frame("new", NewTarget(), sizes);
+}
+
+// short-lived blocks between 8 and 256 bytes allocated by several threads at once, all released together
+void run_parallel_fill(Suite& suite, size_t max_threads) {
+	const std::vector<size_t> sizes = make_mixed_sizes(8, 256, 7);
+
+	for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+		ConcurrentLinearAllocator concurrentLinear(ARENA_SIZE);
+		ConcurrentLinearAllocator bufferedLinear(ARENA_SIZE);
+		LinearAllocator linear(ARENA_SIZE);
+
+		suite.fill("ConcurrentLinearAllocator", [&]() { return LinearTarget<ConcurrentLinearAllocator>{concurrentLinear}; }, sizes, threads);
+		suite.fill("ConcurrentLinear/buffer", [&]() {
+			return ThreadBufferTarget{bufferedLinear, std::unique_ptr<ConcurrentLinearAllocator::ThreadBuffer>(new ConcurrentLinearAllocator::ThreadBuffer(bufferedLinear))};
+		}, sizes, threads);
+		suite.fill("LinearAllocator/mutex", [&]() { return LockedLinearTarget<LinearAllocator>{linear}; }, sizes, threads);
+		suite.fill("malloc", []() { return MallocTarget(); }, sizes, threads);
+		suite.fill("new", []() { return NewTarget(); }, sizes, threads);
+	}
+}
+
+// fixed-size churn of several threads sharing a single allocator
+void run_multithreaded(Suite& suite, size_t max_threads) {
+	const size_t window = 256;
+	const size_t batchSize = 32;
+	const std::vector<size_t> sizes = make_fixed_sizes(OBJECT_SIZE);
+	const std::vector<uint32_t> slots = make_slots(window, 6);
+
+	// room for the live windows and for the blocks cached in the thread cache magazines
+	const size_t poolSize = max_threads * (window + 4 * batchSize) * OBJECT_SIZE + ALIGNMENT;
+
+	for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+		PoolAllocator pool(poolSize, OBJECT_SIZE, ALIGNMENT);
+		PoolAllocator cachedPool(poolSize, OBJECT_SIZE, ALIGNMENT);
+		ThreadCache cache(cachedPool, batchSize);
+		// the blocks cached by CPUs the threads migrated away from are out of reach, the pool grows instead
+		PoolAllocator perCpuPool(poolSize, OBJECT_SIZE, ALIGNMENT, ARENA_SIZE);
+		PerCpuCache perCpuPoolCache(perCpuPool, batchSize);
+		SlabAllocator perCpuSlab(ARENA_SIZE);
+		PerCpuCache perCpuSlabCache(perCpuSlab, batchSize);
+		ConcurrentPoolAllocator concurrentPool(poolSize, OBJECT_SIZE, ALIGNMENT);
+		SlabAllocator slab(ARENA_SIZE);
+
+		suite.churn("mt_churn", "PoolAllocator/mutex", LockedTarget<PoolAllocator>{pool}, sizes, slots, window, threads);
+		suite.churn("mt_churn", "ThreadCache", ThreadCacheTarget{cache}, sizes, slots, window, threads);
+		suite.churn("mt_churn", "PerCpuCache/pool", PerCpuCacheTarget{perCpuPoolCache}, sizes, slots, window, threads);
+		suite.churn("mt_churn", "PerCpuCache/slab", PerCpuCacheTarget{perCpuSlabCache}, sizes, slots, window, threads);
+		suite.churn("mt_churn", "ConcurrentPoolAllocator", RawTarget<ConcurrentPoolAllocator>{concurrentPool}, sizes, slots, window, threads);
+		suite.churn("mt_churn", "SlabAllocator/mutex", LockedTarget<SlabAllocator>{slab}, sizes, slots, window, threads);
+		suite.churn("mt_churn", "malloc", MallocTarget(), sizes, slots, window, threads);
+		suite.churn("mt_churn", "new", NewTarget(), sizes, slots, window, threads);
+
+		cache.flush();
+		perCpuPoolCache.flush();
+		perCpuSlabCache.flush();
+	}
+}
+
+// fixed-size blocks allocated by one thread and deallocated by another, for every pair of threads
+void run_producer_consumer(Suite& suite, size_t max_threads) {
+	// room for the blocks in the queue of a pair and for those the consumer has not freed yet
+	const size_t pairPoolSize = 2 * 256 * OBJECT_SIZE + ALIGNMENT;
+
+	for (size_t threads = 2; threads <= max_threads; threads *= 2) {
+		std::vector<std::unique_ptr<RemoteFreePoolAllocator>> remoteFreePools;
+		for (size_t i = 0; i < threads / 2; ++i)
+			remoteFreePools.emplace_back(new RemoteFreePoolAllocator(pairPoolSize, OBJECT_SIZE, ALIGNMENT));
+		PoolAllocator pool(threads / 2 * pairPoolSize, OBJECT_SIZE, ALIGNMENT);
+
+		suite.producer_consumer("RemoteFreePoolAllocator", [&](size_t pair) { return RemoteFreeTarget{*remoteFreePools[pair]}; }, threads);
+		suite.producer_consumer("PoolAllocator/mutex", [&](size_t pair) { return LockedTarget<PoolAllocator>{pool}; }, threads);
+		suite.producer_consumer("malloc", [](size_t pair) { return MallocTarget(); }, threads);
+		suite.producer_consumer("new", [](size_t pair) { return NewTarget(); }, threads);
+
+		// the destructors reclaim the remote free lists, which only the owner may do
+		for (std::unique_ptr<RemoteFreePoolAllocator>& remoteFreePool : remoteFreePools)
+			remoteFreePool->set_owner_thread();
+	}
+}
+
+void print_usage(const char* program) {
+	std::printf(
+		"usage: %s [options]\n"
+		"  --format=table|csv|json   output format (default table)\n"
+		"  --repetitions=N           measured repetitions of every benchmark (default 10)\n"
+		"  --warmup=N                untimed repetitions run first (default 2)\n"
+		"  --batches=N               timed batches per repetition and thread (default 20)\n"
+		"  --threads=N               largest thread count of the multithreaded benchmarks (default 4)\n"
+		"  --filter=TEXT             only run benchmarks whose workload/allocator name contains TEXT\n",
+		program);
+}
+
+bool parse_arguments(int argc, char** argv, Benchmark::Config& config) {
+	for (int i = 1; i < argc; ++i) {
+		std::string argument = argv[i];
+		size_t separator = argument.find('=');
+		std::string name = argument.substr(0, separator);
+		std::string value = (separator != std::string::npos ? argument.substr(separator + 1) : "");
+
+		if (name == "--format" && value == "table")         config.format = Benchmark::TABLE;
+		else if (name == "--format" && value == "csv")      config.format = Benchmark::CSV;
+		else if (name == "--format" && value == "json")     config.format = Benchmark::JSON;
+		else if (name == "--repetitions" && !value.empty()) config.repetitions = std::strtoul(value.c_str(), nullptr, 10);
+		else if (name == "--warmup" && !value.empty())      config.warmup = std::strtoul(value.c_str(), nullptr, 10);
+		else if (name == "--batches" && !value.empty())     config.batches = std::strtoul(value.c_str(), nullptr, 10);
+		else if (name == "--threads" && !value.empty())     config.maxThreads = std::strtoul(value.c_str(), nullptr, 10);
+		else if (name == "--filter")                        config.filter = value;
+		else return false;
+	}
+
+	return config.repetitions > 0 && config.batches > 0 && config.maxThreads > 0;
+}
+
+int main(int argc, char** argv) {
+	Benchmark::Config config;
+	if (!parse_arguments(argc, argv, config)) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	Suite suite(config);
+	suite.begin();
+
+	run_fixed_churn(suite);
+	run_mixed_churn(suite);
+	run_lifo(suite);
+	run_frame_reset(suite);
+	run_parallel_fill(suite, config.maxThreads);
+	run_multithreaded(suite, config.maxThreads);
+	run_producer_consumer(suite, config.maxThreads);
+
+	suite.end();
+
+	return 0;
+}
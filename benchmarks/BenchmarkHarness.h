@@ -0,0 +1,235 @@
+#ifndef SIMPLE_MEMORY_MANAGER_BENCHMARK_HARNESS_GUARD
+#define SIMPLE_MEMORY_MANAGER_BENCHMARK_HARNESS_GUARD
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+* @brief A namespace encompassing the timing, statistics and reporting shared by the allocator benchmarks.
+*
+* A benchmark runs a workload object through a number of untimed warmup repetitions followed by the measured
+* ones. Every repetition is split into batches, and every batch is timed separately with a steady clock, so
+* a single run yields enough samples for meaningful percentiles. A workload has to provide:
+*
+*   size_t ops_per_batch() const        - number of operations one batch performs
+*   void begin_repetition()             - prepares the state of a repetition, not timed
+*   void run_batch(size_t thread)       - performs one batch on the given thread, timed
+*   void end_repetition()               - releases everything the repetition allocated, not timed
+*/
+namespace Benchmark {
+
+	/**
+	* Output formats of the results.
+	*/
+	enum OutputFormat {
+		TABLE,      /// human readable aligned columns
+		CSV,        /// comma separated values with a header line
+		JSON        /// a single JSON array of result objects
+	};
+
+	/**
+	* Parameters shared by all benchmarks, set from the command line.
+	*/
+	struct Config {
+		size_t          warmup = 2;             /// untimed repetitions run before the measured ones
+		size_t          repetitions = 10;       /// measured repetitions
+		size_t          batches = 20;           /// timed batches in every repetition, per thread
+		size_t          maxThreads = 4;         /// the largest thread count of the multithreaded workloads
+		std::string     filter;                 /// only run benchmarks whose "workload/allocator" name contains this
+		OutputFormat    format = TABLE;         /// output format of the results
+	};
+
+	/**
+	* Summary of a single benchmark, all times are in nanoseconds per operation.
+	*/
+	struct Result {
+		std::string     workload;               /// workload name
+		std::string     allocator;              /// allocator name
+		size_t          threads;                /// number of threads running the workload concurrently
+		size_t          samples;                /// number of timed batches
+		size_t          opsPerSample;           /// operations in every timed batch
+		double          mean;                   /// mean time per operation
+		double          min;                    /// fastest batch
+		double          p50;                    /// median batch
+		double          p90;                    /// 90th percentile batch
+		double          p99;                    /// 99th percentile batch
+		double          max;                    /// slowest batch
+		double          throughput;             /// millions of operations per second of all threads together
+	};
+
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	* @brief Prevents the compiler from optimizing away a value the benchmark does not otherwise use.
+	*/
+	inline void do_not_optimize(void* ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r"(ptr) : "memory");
+#else
+		static void* volatile sink;
+		sink = ptr;
+#endif
+	}
+
+	/**
+	* @brief Returns the percentile of sorted samples, linearly interpolating between the closest ranks.
+	*
+	* @param	sorted  	samples sorted in ascending order, must not be empty
+	* @param	fraction	requested percentile as a fraction between 0 and 1
+	*/
+	inline double percentile(const std::vector<double>& sorted, double fraction) {
+		double rank = fraction * (sorted.size() - 1);
+		size_t lower = (size_t)rank;
+		size_t upper = std::min(lower + 1, sorted.size() - 1);
+
+		return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - lower);
+	}
+
+	/**
+	* @brief Checks whether a benchmark passes the name filter of the configuration.
+	*/
+	inline bool is_selected(const Config& config, const std::string& workload, const std::string& allocator) {
+		return config.filter.empty() || (workload + "/" + allocator).find(config.filter) != std::string::npos;
+	}
+
+	/**
+	* @brief Runs a workload and summarizes its timings.
+	*
+	* With more than one thread, all threads start a repetition at the same time and run their batches
+	* concurrently, the throughput then accounts for all of them together.
+	*
+	* @param	config  	benchmark parameters
+	* @param	workload	name of the workload
+	* @param	allocator	name of the allocator
+	* @param	w       	the workload object
+	* @param	threads 	number of threads running the workload
+	*
+	* @return the summary of the run
+	*/
+	template <class Workload>
+	Result run(const Config& config, const std::string& workload, const std::string& allocator, Workload& w, size_t threads = 1) {
+		std::vector<std::vector<double>> threadSamples(threads);
+		double totalSeconds = 0.0;
+
+		for (size_t repetition = 0; repetition < config.warmup + config.repetitions; ++repetition) {
+			const bool measured = (repetition >= config.warmup);
+
+			w.begin_repetition();
+
+			auto runBatches = [&w, &config, &threadSamples, measured](size_t thread) {
+				for (size_t batch = 0; batch < config.batches; ++batch) {
+					Clock::time_point start = Clock::now();
+					w.run_batch(thread);
+					std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+
+					if (measured)
+						threadSamples[thread].push_back(elapsed.count() / w.ops_per_batch());
+				}
+			};
+
+			Clock::time_point start;
+			if (threads == 1) {
+				start = Clock::now();
+				runBatches(0);
+			} else {
+				// the threads spin until all of them are created, so that they really run concurrently
+				std::atomic<bool> go(false);
+				std::vector<std::thread> workers;
+				for (size_t thread = 0; thread < threads; ++thread) {
+					workers.emplace_back([&go, &runBatches, thread]() {
+						while (!go.load(std::memory_order_acquire))
+							std::this_thread::yield();
+						runBatches(thread);
+					});
+				}
+
+				start = Clock::now();
+				go.store(true, std::memory_order_release);
+				for (std::thread& worker : workers)
+					worker.join();
+			}
+			std::chrono::duration<double> elapsed = Clock::now() - start;
+
+			w.end_repetition();
+
+			if (measured)
+				totalSeconds += elapsed.count();
+		}
+
+		std::vector<double> samples;
+		for (const std::vector<double>& s : threadSamples)
+			samples.insert(samples.end(), s.begin(), s.end());
+		std::sort(samples.begin(), samples.end());
+
+		double sum = 0.0;
+		for (double sample : samples)
+			sum += sample;
+
+		Result result;
+		result.workload = workload;
+		result.allocator = allocator;
+		result.threads = threads;
+		result.samples = samples.size();
+		result.opsPerSample = w.ops_per_batch();
+		result.mean = sum / samples.size();
+		result.min = samples.front();
+		result.p50 = percentile(samples, 0.50);
+		result.p90 = percentile(samples, 0.90);
+		result.p99 = percentile(samples, 0.99);
+		result.max = samples.back();
+		result.throughput = (double)samples.size() * result.opsPerSample / totalSeconds / 1e6;
+
+		return result;
+	}
+
+	/**
+	* Writes results to stdout in the configured format as they come.
+	*/
+	class Reporter {
+	private:
+		OutputFormat    m_format;       /// output format
+		size_t          m_count;        /// number of results written so far
+
+	public:
+		explicit Reporter(OutputFormat format) : m_format(format), m_count(0) { }
+
+		/// writes the header of the output
+		void begin() {
+			if (m_format == TABLE)
+				std::printf("%-14s %-24s %7s %10s %10s %10s %10s %10s %12s\n", "workload", "allocator", "threads", "mean[ns]", "p50[ns]", "p90[ns]", "p99[ns]", "max[ns]", "[Mops/s]");
+			else if (m_format == CSV)
+				std::printf("workload,allocator,threads,samples,ops_per_sample,mean_ns,min_ns,p50_ns,p90_ns,p99_ns,max_ns,throughput_mops\n");
+			else
+				std::printf("[");
+			std::fflush(stdout);
+		}
+
+		/// writes a single result
+		void report(const Result& r) {
+			if (m_format == TABLE)
+				std::printf("%-14s %-24s %7zu %10.2f %10.2f %10.2f %10.2f %10.2f %12.2f\n", r.workload.c_str(), r.allocator.c_str(), r.threads, r.mean, r.p50, r.p90, r.p99, r.max, r.throughput);
+			else if (m_format == CSV)
+				std::printf("%s,%s,%zu,%zu,%zu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", r.workload.c_str(), r.allocator.c_str(), r.threads, r.samples, r.opsPerSample, r.mean, r.min, r.p50, r.p90, r.p99, r.max, r.throughput);
+			else
+				std::printf("%s\n  {\"workload\": \"%s\", \"allocator\": \"%s\", \"threads\": %zu, \"samples\": %zu, \"ops_per_sample\": %zu, "
+					"\"mean_ns\": %.3f, \"min_ns\": %.3f, \"p50_ns\": %.3f, \"p90_ns\": %.3f, \"p99_ns\": %.3f, \"max_ns\": %.3f, \"throughput_mops\": %.3f}",
+					(m_count > 0 ? "," : ""), r.workload.c_str(), r.allocator.c_str(), r.threads, r.samples, r.opsPerSample, r.mean, r.min, r.p50, r.p90, r.p99, r.max, r.throughput);
+			std::fflush(stdout);
+			++m_count;
+		}
+
+		/// finishes the output
+		void end() {
+			if (m_format == JSON)
+				std::printf("\n]\n");
+			std::fflush(stdout);
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,107 @@
+#include <SimpleMemoryAllocator.h>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using SimpleMemoryAllocator::AssertException;
+
+const uint8_t MIN_ORDER = 12;       // 4 KiB
+const uint8_t MAX_ORDER = 22;       // 4 MiB
+const size_t NUM_MAX_BLOCKS = 16;
+
+// splits every large block into the smallest ones and frees them in random order,
+// the buddies have to merge back so that all the largest blocks can be allocated again
+void check_merging(SimpleMemoryAllocator::BuddyAllocator& allocator) {
+	const size_t minBlock = (size_t)1 << MIN_ORDER;
+	const size_t maxBlock = (size_t)1 << MAX_ORDER;
+	const size_t numMinBlocks = NUM_MAX_BLOCKS * (maxBlock / minBlock);
+
+	std::vector<void*> blocks;
+	for (size_t i = 0; i < numMinBlocks; ++i) {
+		blocks.push_back(allocator.allocate_raw(minBlock, 16));
+		throw_assert(blocks.back() != nullptr, "the whole memory should be usable by the smallest blocks");
+	}
+	throw_assert(allocator.allocate_raw(minBlock, 16) == nullptr, "the allocator should be full");
+
+	std::shuffle(blocks.begin(), blocks.end(), std::mt19937(42));
+	for (void* block : blocks)
+		allocator.deallocate_raw(block);
+	throw_assert(allocator.get_used_memory() == 0, "all memory should be freed");
+
+	blocks.clear();
+	for (size_t i = 0; i < NUM_MAX_BLOCKS; ++i) {
+		blocks.push_back(allocator.allocate_raw(maxBlock, 16));
+		throw_assert(blocks.back() != nullptr, "freed buddies should be merged back to the largest blocks");
+	}
+	for (void* block : blocks)
+		allocator.deallocate_raw(block);
+
+	std::cout << "merged " << numMinBlocks << " blocks of " << minBlock << " bytes back into " << NUM_MAX_BLOCKS << " blocks of " << maxBlock << " bytes\n";
+}
+
+// log-uniformly distributed I/O buffer sizes between the smallest and the largest block
+std::vector<size_t> make_sizes(size_t count) {
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<double> exponent(MIN_ORDER, MAX_ORDER - 2);
+
+	std::vector<size_t> sizes;
+	for (size_t i = 0; i < count; ++i)
+		sizes.push_back((size_t)std::exp2(exponent(generator)));
+
+	return sizes;
+}
+
+// keeps a window of live buffers, replacing a random one in every step
+template <class Allocate, class Deallocate>
+double run_benchmark(const std::vector<size_t>& sizes, size_t window, Allocate allocate, Deallocate deallocate) {
+	std::vector<void*> live(window, nullptr);
+	std::mt19937 generator(11);
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < sizes.size(); ++i) {
+		size_t slot = generator() % window;
+		if (live[slot] != nullptr)
+			deallocate(live[slot]);
+
+		live[slot] = allocate(sizes[i]);
+	}
+
+	for (void* ptr : live)
+		if (ptr != nullptr)
+			deallocate(ptr);
+
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / sizes.size();
+}
+
+int main(int argc, char** argv) {
+	SimpleMemoryAllocator::BuddyAllocator allocator(NUM_MAX_BLOCKS << MAX_ORDER, MIN_ORDER, MAX_ORDER);
+
+	try {
+		check_merging(allocator);
+	} catch (const AssertException& e) {
+		std::cout << "AssertException caught: " << e.what() << "\n";
+		return 1;
+	}
+
+	const std::vector<size_t> sizes = make_sizes(1000000);
+	const size_t window = 32;
+	size_t failed = 0;
+
+	double buddy = run_benchmark(sizes, window,
+		[&allocator, &failed](size_t size) { void* ptr = allocator.allocate_raw(size, 16); failed += (ptr == nullptr); return ptr; },
+		[&allocator](void* ptr) { allocator.deallocate_raw(ptr); });
+
+	double native = run_benchmark(sizes, window,
+		[](size_t size) { return ::operator new(size); },
+		[](void* ptr) { ::operator delete(ptr); });
+
+	std::cout << "BuddyAllocator: " << buddy << " ns per allocation/deallocation pair (" << failed << " failed allocations)\n";
+	std::cout << "::operator new: " << native << " ns per allocation/deallocation pair\n";
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include <SimpleMemoryAllocator.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+
+struct Message {
+	uint64_t id;
+	uint64_t payload[7];
+};
+
+const int OBJECTS_PER_ROUND = 64;
+const int ROUNDS_PER_THREAD = 20000;
+
+// every thread repeatedly allocates a handful of objects and frees them again, which is the typical
+// life cycle of short-lived messages passed around by worker threads
+template <class Allocate, class Deallocate>
+double run_threads(int num_threads, Allocate allocate, Deallocate deallocate) {
+	std::vector<std::thread> threads;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (int t = 0; t < num_threads; ++t) {
+		threads.emplace_back([&allocate, &deallocate]() {
+			Message* objects[OBJECTS_PER_ROUND];
+
+			for (int round = 0; round < ROUNDS_PER_THREAD; ++round) {
+				for (int i = 0; i < OBJECTS_PER_ROUND; ++i) {
+					objects[i] = allocate();
+					objects[i]->id = i;
+				}
+				for (int i = 0; i < OBJECTS_PER_ROUND; ++i)
+					deallocate(objects[i]);
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	// million allocation+deallocation pairs per second
+	return (double)num_threads * ROUNDS_PER_THREAD * OBJECTS_PER_ROUND / elapsed.count() / 1e6;
+}
+
+int main(int argc, char** argv) {
+	int maxThreads = (argc > 1 ? std::atoi(argv[1]) : (int)std::thread::hardware_concurrency());
+	if (maxThreads < 1) maxThreads = 1;
+
+	const size_t batchSize = 32;
+	const size_t poolObjects = (size_t)maxThreads * (OBJECTS_PER_ROUND + 2 * batchSize);
+
+	SimpleMemoryAllocator::PoolAllocator pool(poolObjects * sizeof(Message) + alignof(Message), sizeof(Message), alignof(Message));
+	SimpleMemoryAllocator::ThreadCache cache(pool, batchSize);
+	SimpleMemoryAllocator::ConcurrentPoolAllocator concurrentPool(poolObjects * sizeof(Message) + alignof(Message), sizeof(Message), alignof(Message));
+
+	std::cout << "threads, mutex [Mops/s], thread cache [Mops/s], lock-free pool [Mops/s], new/delete [Mops/s]\n";
+
+	for (int threads = 1; threads <= maxThreads; ++threads) {
+		double locked = run_threads(threads,
+			[&pool]() { return pool.allocate_thread_safe<Message>(); },
+			[&pool](Message* m) { pool.deallocate_thread_safe(*m); });
+
+		double cached = run_threads(threads,
+			[&cache]() { return cache.allocate<Message>(); },
+			[&cache](Message* m) { cache.deallocate(*m); });
+
+		double lockFree = run_threads(threads,
+			[&concurrentPool]() { return concurrentPool.allocate<Message>(); },
+			[&concurrentPool](Message* m) { concurrentPool.deallocate(*m); });
+
+		double native = run_threads(threads,
+			[]() { return new Message; },
+			[](Message* m) { delete m; });
+
+		std::cout << std::setw(7) << threads << ", "
+			<< std::fixed << std::setprecision(2)
+			<< locked << ", " << cached << ", " << lockFree << ", " << native << "\n";
+	}
+
+	cache.flush();
+
+	return 0;
+}
@@ -0,0 +1,113 @@
+#ifndef SIMPLE_MEMORY_MANAGER_ALLOCATOR_STATS_GUARD
+#define SIMPLE_MEMORY_MANAGER_ALLOCATOR_STATS_GUARD
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A snapshot of the statistics of an allocator, returned by BaseAllocator::get_stats().
+	*
+	* The current state (usage, free space and fragmentation) is always available. The counters gathered over
+	* the lifetime of the allocator (peaks, totals, failures, padding and the request size histogram) are only
+	* collected when the library and the code using it are compiled with SIMPLE_MEMORY_ALLOCATOR_STATS defined,
+	* otherwise they stay 0 and the allocation methods carry no overhead at all.
+	*/
+	struct AllocatorStats {
+		static const size_t NUM_SIZE_BUCKETS = 64;     /// number of buckets of the request size histogram
+
+		bool        collected;              /// whether the lifetime counters were collected
+
+		// current state
+		size_t      capacity;               /// memory the allocator manages in bytes
+		size_t      usedMemory;             /// memory currently in use in bytes, including padding and headers
+		size_t      numAllocations;         /// number of live allocations
+		size_t      freeMemory;             /// memory currently available in bytes
+		size_t      largestFreeBlock;       /// size of the largest block the allocator could hand out right now in bytes
+		double      fragmentation;          /// 1 - largestFreeBlock / freeMemory, 0 if the free memory is in one piece or cannot fragment
+
+		// lifetime counters
+		size_t      peakUsedMemory;         /// high-water mark of the used memory in bytes
+		size_t      peakNumAllocations;     /// high-water mark of the number of live allocations
+		size_t      totalAllocations;       /// number of successful allocations
+		size_t      totalDeallocations;     /// number of deallocations
+		size_t      failedAllocations;      /// number of allocations which returned nullptr
+		size_t      requestedBytes;         /// sum of all successfully allocated sizes as requested
+		size_t      paddingBytes;           /// memory used on top of the requested sizes (alignment, headers, rounding) in bytes
+		size_t      sizeHistogram[NUM_SIZE_BUCKETS];    /// request counts, bucket i holds the sizes in [2^i, 2^(i+1))
+
+		/**
+		* @brief Creates an empty snapshot with all values set to 0.
+		*/
+		AllocatorStats();
+
+		/**
+		* @brief Sets the free memory and the largest free block, and computes the fragmentation from them.
+		*
+		* @param	free_memory         	memory currently available in bytes
+		* @param	largest_free_block  	size of the largest block the allocator could hand out right now in bytes
+		*/
+		void set_free_space(size_t free_memory, size_t largest_free_block) {
+			freeMemory = free_memory;
+			largestFreeBlock = largest_free_block;
+			fragmentation = (free_memory > 0 ? 1.0 - (double)largest_free_block / free_memory : 0.0);
+		}
+
+		/**
+		* @brief Records an allocation, called by the allocation methods when the statistics are collected.
+		*
+		* @param	size            	requested size in bytes
+		* @param	ptr             	the returned block, nullptr if the allocation failed
+		* @param	used_before     	used memory of the allocator before the allocation
+		* @param	used_after      	used memory of the allocator after the allocation
+		* @param	num_allocations 	number of live allocations after the allocation
+		*/
+		void record_allocation(size_t size, const void* ptr, size_t used_before, size_t used_after, size_t num_allocations);
+
+		/**
+		* @brief Records a batch of equally sized allocations, called by the batch allocation methods when the statistics are collected.
+		*
+		* @param	size            	requested size of every block in bytes
+		* @param	requested       	number of requested blocks
+		* @param	allocated       	number of blocks actually allocated
+		* @param	used_before     	used memory of the allocator before the batch
+		* @param	used_after      	used memory of the allocator after the batch
+		* @param	num_allocations 	number of live allocations after the batch
+		*/
+		void record_batch_allocation(size_t size, size_t requested, size_t allocated, size_t used_before, size_t used_after, size_t num_allocations);
+
+		/**
+		* @brief Records deallocations, called by the deallocation methods when the statistics are collected.
+		*
+		* @param	count   	number of deallocated blocks
+		*/
+		void record_deallocation(size_t count = 1) { totalDeallocations += count; }
+
+		/**
+		* @brief Records a block resized in place, called by the reallocation methods when the statistics are collected.
+		*
+		* @param	used_after      	used memory of the allocator after the resize
+		*/
+		void record_resize(size_t used_after) { peakUsedMemory = (used_after > peakUsedMemory ? used_after : peakUsedMemory); }
+
+		/**
+		* @brief Resets the lifetime counters, the peaks start over from the current usage.
+		*
+		* @param	used_memory     	used memory of the allocator
+		* @param	num_allocations 	number of live allocations
+		*/
+		void reset(size_t used_memory, size_t num_allocations);
+
+		/**
+		* @brief Writes the snapshot as a single JSON object, the histogram only lists non-empty buckets keyed by their lower bound.
+		*
+		* @param	stream	the output stream
+		*/
+		void write_json(std::ostream& stream) const;
+	};
+
+}
+
+#endif
@@ -1,271 +1,875 @@
-#ifndef SIMPLE_MEMORY_MANAGER_BASE_ALLOCATOR_GUARD
-#define SIMPLE_MEMORY_MANAGER_BASE_ALLOCATOR_GUARD
-
-#include <cstddef>
-#include <cstdint>
-#include <mutex>
-#include <iostream>
-#include <AssertException.h>
-#include <MemUtils.h>
-
-namespace SimpleMemoryAllocator {
-
-	/**
-	* The base custom allocator class containing all the common interface methods and members. All allocators inherit from this class.
-	*/
-	class BaseAllocator {
-	private:
-		bool	    m_handling_memory_internally = false;  /// a boolean flag to indicate the allocator is handling the system memory allocation
-		std::mutex  m_allocator_mutex;
-
-	protected:
-		void*       m_start;                              /// pointer to the beginning of the allocated memory
-		size_t      m_size;                               /// size of the allocated memory in bytes
-		size_t      m_used_memory;                        /// amount of used memory in bytes
-		size_t      m_num_allocations;                    /// allocation counter, increments with allocations and decrements with deallocations
-
-		BaseAllocator(const BaseAllocator&) = delete;	          // disable copy-constructor
-
-		////////////////////////////////////////////////////////////////////////////
-		// main logic methods, these are to be implemented in specific allocators //
-		//////////////////////////////////////////////////////////////////////////////////////////////
-		/**
-		* @brief An internal method handling new variable allocation. Specific for each allocator type.
-		*
-		* @param	size        size of allocated variable in bytes
-		* @param	alignment   memory alignment of the variable type
-		*
-		* @return a pointer to a newly allocated variable
-		*/
-		virtual void* __allocate(size_t size, uint8_t alignment = 0) = 0;
-
-		/**
-		* @brief An internal method handling variable deallocation. Specific for each allocator type.
-		*
-		* @param	ptr         pointer to a memory previously allocated by __allocate()
-		*/
-		virtual void __deallocate(void* ptr) = 0;
-
-	public:
-		/**
-		* @brief Standard constructor, initializes the basic necessary allocator data. 
-		*
-		* If start is nullptr, it uses native C++ ::operator new to allocate needed system memory.
-		* 
-		* @param	start       a pointer to the beginning of the allocated memory space
-		* @param	size        size of the allocated memory space in bytes
-		*/
-		BaseAllocator(void* start, size_t size) {
-			m_start = (start != nullptr ? start : allocate_memory_native(size));
-			m_size = size;
-			m_used_memory = 0;
-			m_num_allocations = 0;
-		}
-
-		/**
-		* @brief Default destructor, able to detect nondeallocated memory and possible deallocation faults
-		*/
-		virtual ~BaseAllocator() {
-			if (m_num_allocations != 0 || m_used_memory != 0)
-				std::cerr 
-					<< "All memory shoudld be deallocated before destruction, currently leaking " 
-					<< m_num_allocations << " allocations with total size of " << m_used_memory << " bytes.\n";
-
-			deallocate_memory_native();
-
-			m_start = nullptr;
-			m_size = 0;
-		}
-
-	private:
-		///////////////////////////////////////////////////
-		// native memory allocation/deallocation methods //
-		//////////////////////////////////////////////////////////////////////////////////////////////
-
-		/**
-		* @brief Allocates system memory using ::operator new.
-		*
-		* @param	sizeBytes	allocated memory size in bytes
-		*
-		* @return a void pointer to the newly allocated memory
-		*/
-		inline void* allocate_memory_native(size_t sizeBytes) {
-			m_handling_memory_internally = true;
-			return ::operator new(sizeBytes);
-		}
-		
-		/**
-		* @brief Deallocates the system memory allocated by allocateMemoryNative()
-		*/
-		inline void deallocate_memory_native() {
-			if (m_handling_memory_internally)
-				::operator delete(m_start);
-		}
-
-	public:
-		//////////////////////////////
-		// interface getter methods //
-		//////////////////////////////////////////////////////////////////////////////////////////////
-		/// initial memory position getter
-		void* get_start() const noexcept { return m_start; }
-		/// allocator size getter
-		size_t get_size() const noexcept { return m_size; }
-		/// memory used by allocator (in bytes) getter
-		size_t get_used_memory() const noexcept { return m_used_memory; }
-		/// number of active allocations getter
-		size_t get_num_allocations() const noexcept { return m_num_allocations; }
-
-
-		/////////////////////////////////
-		// allocator interface methods //
-		//////////////////////////////////////////////////////////////////////////////////////////////
-
-		/**
-		* @brief Allocates a single object of specified class.
-		*
-		* @param	T	template type of the new variable
-		*
-		* @return a pointer to the newly allocated class instance
-		*/
-		template <class T> T* allocate() {
-			return new (__allocate(sizeof(T), alignof(T))) T;
-		}
-
-		/**
-		* @brief Allocates a single object of specified class in a thread-safe manner.
-		*
-		* @param	T	template type of the new variable
-		*
-		* @return a pointer to the newly allocated class instance
-		*/
-		template <class T> T* allocate_thread_safe() {
-			std::lock_guard<std::mutex> lock(m_allocator_mutex);
-			return allocate<T>();
-		}
-
-		/**
-		* @brief Allocates a single object of specified class with copy constructor.
-		* 
-		* @param	T	template type of the new variable
-		* @param	t	an instance of class T to be copied to the newly allocated one
-		*
-		* @return a pointer to the newly allocated class instance
-		*/
-		template <class T> T* allocate(const T& t) {
-			return new (__allocate(sizeof(T), alignof(T))) T(t);
-		}
-
-		/**
-		* @brief Allocates a single object of specified class with copy constructor in a thread-safe manner.
-		* 
-		* @param	T	template type of the new variable
-		* @param	t	an instance of class T to be copied to the newly allocated one
-		*
-		* @return a pointer to the newly allocated class instance
-		*/
-		template <class T> T* allocate_thread_safe(const T& t) {
-			std::lock_guard<std::mutex> lock(m_allocator_mutex);
-			return allocate<T>(t);
-		}
-
-		/**
-		* @brief Deallocates a single object specified by a pointer.
-		* 
-		* @param	T	template type of the deleted variable
-		* @param	object	pointer to a previously allocated object
-		*/
-		template <class T> void deallocate(T& object) {
-			object.~T();
-			__deallocate(&object);
-		}
-
-		/**
-		* @brief Deallocates a single object specified by a pointer in a thread-safe manner.
-		* 
-		* @param	T	template type of the deleted variable
-		* @param	object	pointer to a previously allocated object
-		*/
-		template <class T> void deallocate_thread_safe(T& object) {
-			std::lock_guard<std::mutex> lock(m_allocator_mutex);
-			deallocate(object);
-		}
-
-		/**
-		* @brief Allocates an array of objects of specified class.
-		* 
-		* @param	T	template type of the new array
-		* @param	length	size of the array
-		*
-		* @return a pointer to the newly allocated class instance array
-		*/
-			template <class T> T* allocate_array(size_t length) {
-			throw_assert(length > 0, "allocated array length must be larger than 0");
-
-			// calculate how many T-sized chucks we need to allocate to store the array length
-			uint8_t headerSize = sizeof(size_t) / sizeof(T);
-			if (sizeof(size_t) % sizeof(T) > 0) 
-				headerSize += 1;
-
-			// allocate extra memory before the array to store its size
-			T* ptr = ((T*) __allocate(sizeof(T) * (length + headerSize), alignof(T))) + headerSize;
-			*( ((size_t*)ptr) - 1 ) = length;
-			
-			// initialize all array elements
-			for (size_t i = 0; i < length; ++i)
-				new (&ptr) T;
-
-			return ptr;
-		}
-
-		/**
-		* @brief Allocates an array of objects of specified class in a thread-safe manner.
-		* 
-		* @param	T	template type of the new array
-		* @param	length	size of the array
-		*
-		* @return a pointer to the newly allocated class instance array
-		*/
-		template <class T> T* allocate_array_thread_safe(size_t length) {
-			std::lock_guard<std::mutex> lock(m_allocator_mutex);
-				return allocate_array<T>(length);
-		}
-
-		/**
-		* @brief Deallocates an array of objects specified by a pointer.
-		* 
-		* @param	T	template type of the deleted array
-		* @param	array	a pointer to a previously allocated array
-		*/
-		template <class T> void deallocate_array(T* array) {
-			throw_assert(array != nullptr, "deallocated array pointer must not be null");
-
-			// calculate header size
-			uint8_t headerSize = sizeof(size_t) / sizeof(T);
-			if (sizeof(size_t) % sizeof(T) > 0)
-				headerSize += 1;
-
-			// get array length
-			size_t length = *( ((size_t*)array) - 1 );
-
-			// destroy all array elements
-			for (size_t i = 0; i < length; ++i)
-				array[i].~T();
-
-			// deallocate the memory
-			__deallocate(array - headerSize);
-		}
-
-		/**
-		* @brief Deallocates an array of objects specified by a pointer in a thread-safe manner.
-		* 
-		* @param	T	template type of the deleted array
-		* @param	array	a pointer to a previously allocated array
-		*/
-		template <class T> void deallocate_array_thread_safe(T* array) {
-			std::lock_guard<std::mutex> lock(m_allocator_mutex);
-			deallocate_array(array);
-		}
-	};
-}
-
+#ifndef SIMPLE_MEMORY_MANAGER_BASE_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_BASE_ALLOCATOR_GUARD
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <iostream>
+#include <type_traits>
+#include <utility>
+#include <AssertException.h>
+#include <MemUtils.h>
+#include <AllocatorStats.h>
+#include <MemorySource.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* How the elements of a newly allocated array are initialized.
+	*/
+	enum ArrayInitialization {
+		UNINITIALIZED,          /// no constructor is called, the elements have to be constructed by the caller
+		DEFAULT_INITIALIZED,    /// as by new T[n], the default constructor is called, trivial types are left uninitialized
+		VALUE_INITIALIZED       /// as by new T[n](), trivial types are zeroed by a single memset
+	};
+
+	/**
+	* The base custom allocator class containing all the common interface methods and members. All allocators inherit from this class.
+	*/
+	class BaseAllocator {
+	private:
+		MemorySource*   m_memory_source;                    /// the upstream source of the memory and of additional chunks
+		bool            m_owns_memory = false;              /// whether the memory was taken from the source and is given back on destruction
+		std::mutex      m_allocator_mutex;
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+		AllocatorStats  m_stats;                          /// lifetime statistics gathered by the allocation methods
+#endif
+
+	protected:
+		void*       m_start;                              /// pointer to the beginning of the allocated memory
+		size_t      m_size;                               /// size of the allocated memory in bytes
+		size_t      m_used_memory;                        /// amount of used memory in bytes
+		size_t      m_num_allocations;                    /// allocation counter, increments with allocations and decrements with deallocations
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+		bool        m_record_stats = true;                /// cleared by allocators which gather the lifetime statistics themselves
+#endif
+		bool        m_deallocates_blocks = true;          /// cleared by allocators which cannot deallocate single blocks, a relocated block is then left for clear()
+
+		BaseAllocator(const BaseAllocator&) = delete;	          // disable copy-constructor
+
+		////////////////////////////////////////////////////////////////////////////
+		// main logic methods, these are to be implemented in specific allocators //
+		//////////////////////////////////////////////////////////////////////////////////////////////
+		/**
+		* @brief An internal method handling new variable allocation. Specific for each allocator type.
+		*
+		* @param	size        size of allocated variable in bytes
+		* @param	alignment   memory alignment of the variable type
+		*
+		* @return a pointer to a newly allocated variable
+		*/
+		virtual void* __allocate(size_t size, size_t alignment = 0) = 0;
+
+		/**
+		* @brief An internal method handling variable deallocation. Specific for each allocator type.
+		*
+		* @param	ptr         pointer to a memory previously allocated by __allocate()
+		*/
+		virtual void __deallocate(void* ptr) = 0;
+
+		/**
+		* @brief An internal method handling the allocation of a batch of equally sized blocks. By default, it calls
+		* __allocate() for every block, allocators able to hand out many blocks at once override this.
+		*
+		* @param	out         array receiving the pointers to the allocated blocks
+		* @param	count       number of requested blocks
+		* @param	size        size of a single block in bytes
+		* @param	alignment   memory alignment of the blocks
+		*
+		* @return number of blocks allocated, the first ones of out, less than count if the allocator ran out of memory
+		*/
+		virtual size_t __allocate_batch(void** out, size_t count, size_t size, size_t alignment) {
+			for (size_t i = 0; i < count; ++i) {
+				if ((out[i] = __allocate(size, alignment)) == nullptr) return i;
+			}
+			return count;
+		}
+
+		/**
+		* @brief An internal method handling the deallocation of a batch of blocks. By default, it calls __deallocate()
+		* for every block, in reverse order so that LIFO allocators can handle a batch they allocated.
+		*
+		* @param	blocks      array of pointers to memory previously allocated by __allocate() or __allocate_batch()
+		* @param	count       number of blocks
+		*/
+		virtual void __deallocate_batch(void** blocks, size_t count) {
+			for (size_t i = count; i-- > 0;)
+				__deallocate(blocks[i]);
+		}
+
+		/**
+		* @brief An internal method resizing a block without moving it. By default, no block can be resized, allocators
+		* which can grow or shrink some blocks where they are override this.
+		*
+		* @param	ptr         pointer to a memory previously allocated by __allocate()
+		* @param	old_size    current size of the block in bytes, as it was requested
+		* @param	new_size    requested size of the block in bytes, smaller or larger than old_size
+		*
+		* @return true if the block was resized, false if it was left untouched
+		*/
+		virtual bool __try_expand_in_place(void* ptr, size_t old_size, size_t new_size) {
+			return false;
+		}
+
+		/**
+		* @brief An internal method deciding whether the old block of a reallocation that moved it can be deallocated.
+		* By default, it can whenever the allocator deallocates single blocks, allocators restricting the order of
+		* deallocations override this, the block is otherwise left where it is.
+		*
+		* @param	ptr         pointer to the old block, the new one is already allocated
+		* @param	size        size of the old block in bytes, as it was requested
+		*
+		* @return true if the old block can be deallocated
+		*/
+		virtual bool __can_deallocate_moved(const void* ptr, size_t size) const {
+			return m_deallocates_blocks;
+		}
+
+		/**
+		* @brief Fills the allocator specific part of a statistics snapshot: the free space and fragmentation. By default,
+		* the unused memory is considered a single contiguous block, allocators with a different layout override this.
+		*
+		* @param	stats       the snapshot with the capacity, used memory and number of allocations already set
+		*/
+		virtual void fill_stats(AllocatorStats& stats) const {
+			size_t freeMemory = (stats.capacity > stats.usedMemory ? stats.capacity - stats.usedMemory : 0);
+			stats.set_free_space(freeMemory, freeMemory);
+		}
+
+	public:
+		/**
+		* @brief Standard constructor, initializes the basic necessary allocator data. 
+		*
+		* If start is nullptr, it takes the needed memory from the memory source, which is native C++ ::operator new
+		* unless stated otherwise. Throws std::bad_alloc if the source is out of memory.
+		* 
+		* @param	start       a pointer to the beginning of the allocated memory space
+		* @param	size        size of the allocated memory space in bytes
+		* @param	memory_source	source of the memory and of additional chunks, nullptr for MemorySource::get_default()
+		*/
+		BaseAllocator(void* start, size_t size, MemorySource* memory_source = nullptr) {
+			m_memory_source = (memory_source != nullptr ? memory_source : &MemorySource::get_default());
+			m_start = (start != nullptr ? start : allocate_memory_native(size));
+			m_size = size;
+			m_used_memory = 0;
+			m_num_allocations = 0;
+		}
+
+		/**
+		* @brief Default destructor, able to detect nondeallocated memory and possible deallocation faults
+		*/
+		virtual ~BaseAllocator() {
+			if (m_num_allocations != 0 || m_used_memory != 0)
+				std::cerr 
+					<< "All memory shoudld be deallocated before destruction, currently leaking " 
+					<< m_num_allocations << " allocations with total size of " << m_used_memory << " bytes.\n";
+
+			deallocate_memory_native();
+
+			m_start = nullptr;
+			m_size = 0;
+		}
+
+	private:
+		///////////////////////////////////////////////////
+		// native memory allocation/deallocation methods //
+		//////////////////////////////////////////////////////////////////////////////////////////////
+
+		/**
+		* @brief Takes the allocator memory from the memory source.
+		*
+		* @param	sizeBytes	allocated memory size in bytes
+		*
+		* @return a void pointer to the newly allocated memory
+		*/
+		inline void* allocate_memory_native(size_t sizeBytes) {
+			void* memory = m_memory_source->allocate_region(sizeBytes);
+			if (memory == nullptr) throw std::bad_alloc();
+
+			m_owns_memory = true;
+			return memory;
+		}
+		
+		/**
+		* @brief Gives the memory allocated by allocateMemoryNative() back to the memory source
+		*/
+		inline void deallocate_memory_native() {
+			if (m_owns_memory)
+				m_memory_source->deallocate_region(m_start, m_size);
+		}
+
+		/**
+		* @brief Calls __allocate() and records the allocation when the statistics are collected.
+		*/
+		inline void* allocate_tracked(size_t size, size_t alignment) {
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+			size_t usedBefore = m_used_memory;
+			void* ptr = __allocate(size, alignment);
+			if (m_record_stats)
+				m_stats.record_allocation(size, ptr, usedBefore, m_used_memory, m_num_allocations);
+			return ptr;
+#else
+			return __allocate(size, alignment);
+#endif
+		}
+
+		/**
+		* @brief Calls __deallocate() and records the deallocation when the statistics are collected.
+		*/
+		inline void deallocate_tracked(void* ptr) {
+			__deallocate(ptr);
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+			if (m_record_stats)
+				m_stats.record_deallocation();
+#endif
+		}
+
+		/**
+		* @brief Calls __try_expand_in_place() and records the new peak when the statistics are collected.
+		*/
+		inline bool expand_in_place_tracked(void* ptr, size_t old_size, size_t new_size) {
+			throw_assert(ptr != nullptr, "resized pointer must not be null");
+			throw_assert(new_size > 0, "resized size must be larger than 0");
+
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+			bool resized = __try_expand_in_place(ptr, old_size, new_size);
+			if (resized && m_record_stats)
+				m_stats.record_resize(m_used_memory);
+			return resized;
+#else
+			return __try_expand_in_place(ptr, old_size, new_size);
+#endif
+		}
+
+		/**
+		* @brief Resizes a block in place if possible, otherwise moves it to a new block, copying its bytes.
+		*/
+		inline void* reallocate_tracked(void* ptr, size_t old_size, size_t new_size, size_t alignment) {
+			if (ptr == nullptr) return allocate_tracked(new_size, alignment);
+			if (expand_in_place_tracked(ptr, old_size, new_size)) return ptr;
+
+			// a shrunk block can always stay where it is, it only keeps the unused tail
+			if (new_size <= old_size) return ptr;
+
+			void* newPtr = allocate_tracked(new_size, alignment);
+			if (newPtr == nullptr) return nullptr;
+
+			std::memcpy(newPtr, ptr, old_size);
+			if (__can_deallocate_moved(ptr, old_size))
+				deallocate_tracked(ptr);
+
+			return newPtr;
+		}
+
+		/**
+		* @brief Calls __allocate_batch() and records the allocations when the statistics are collected.
+		*/
+		inline size_t allocate_batch_tracked(void** out, size_t count, size_t size, size_t alignment) {
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+			size_t usedBefore = m_used_memory;
+			size_t allocated = __allocate_batch(out, count, size, alignment);
+			if (m_record_stats)
+				m_stats.record_batch_allocation(size, count, allocated, usedBefore, m_used_memory, m_num_allocations);
+			return allocated;
+#else
+			return __allocate_batch(out, count, size, alignment);
+#endif
+		}
+
+		/**
+		* @brief Calls __deallocate_batch() and records the deallocations when the statistics are collected.
+		*/
+		inline void deallocate_batch_tracked(void** blocks, size_t count) {
+			__deallocate_batch(blocks, count);
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+			if (m_record_stats)
+				m_stats.record_deallocation(count);
+#endif
+		}
+
+	protected:
+		/**
+		* @brief Takes an additional chunk from the memory source for allocators able to grow.
+		*
+		* @param	sizeBytes	allocated chunk size in bytes
+		*
+		* @return a void pointer to the newly allocated chunk, or nullptr if the source is out of memory
+		*/
+		inline void* allocate_chunk(size_t sizeBytes) {
+			return m_memory_source->allocate_region(sizeBytes);
+		}
+
+		/**
+		* @brief Gives a chunk allocated by allocate_chunk() back to the memory source
+		*
+		* @param	chunk		pointer to the chunk
+		* @param	sizeBytes	size of the chunk in bytes
+		*/
+		inline void deallocate_chunk(void* chunk, size_t sizeBytes) {
+			m_memory_source->deallocate_region(chunk, sizeBytes);
+		}
+
+	public:
+		//////////////////////////////
+		// interface getter methods //
+		//////////////////////////////////////////////////////////////////////////////////////////////
+		/// initial memory position getter
+		void* get_start() const noexcept { return m_start; }
+		/// allocator size getter
+		size_t get_size() const noexcept { return m_size; }
+		/// memory used by allocator (in bytes) getter
+		size_t get_used_memory() const noexcept { return m_used_memory; }
+		/// number of active allocations getter
+		size_t get_num_allocations() const noexcept { return m_num_allocations; }
+		/// whether single blocks can be deallocated getter, false for the allocators which only release their memory all at once
+		bool can_deallocate_blocks() const noexcept { return m_deallocates_blocks; }
+		/// memory source getter
+		MemorySource& get_memory_source() const noexcept { return *m_memory_source; }
+		/// allocator mutex getter, lock it to make a sequence of raw calls atomic with respect to the *_thread_safe methods
+		std::mutex& get_mutex() noexcept { return m_allocator_mutex; }
+
+		/**
+		* @brief Takes a snapshot of the allocator statistics. The free space is computed on demand, which
+		* may walk the free blocks of some allocators, so this is not meant for hot paths.
+		*
+		* @return the statistics snapshot, see AllocatorStats for which values are always available
+		*/
+		AllocatorStats get_stats() const {
+			AllocatorStats stats;
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+			stats = m_stats;
+			stats.collected = true;
+#endif
+			stats.capacity = m_size;
+			stats.usedMemory = m_used_memory;
+			stats.numAllocations = m_num_allocations;
+			fill_stats(stats);
+
+			return stats;
+		}
+
+		/**
+		* @brief Resets the collected lifetime statistics, the peaks start over from the current usage.
+		*/
+		void reset_stats() {
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+			m_stats.reset(m_used_memory, m_num_allocations);
+#endif
+		}
+
+
+		/////////////////////////////////
+		// allocator interface methods //
+		//////////////////////////////////////////////////////////////////////////////////////////////
+
+		/**
+		* @brief Allocates a raw block of uninitialized memory, no constructor is called.
+		*
+		* @param	size        size of the block in bytes
+		* @param	alignment   memory alignment of the block
+		*
+		* @return a pointer to the newly allocated block, or nullptr if the allocator is out of memory
+		*/
+		void* allocate_raw(size_t size, size_t alignment = alignof(std::max_align_t)) {
+			return allocate_tracked(size, alignment);
+		}
+
+		/**
+		* @brief Allocates a raw block of uninitialized memory in a thread-safe manner.
+		*
+		* @param	size        size of the block in bytes
+		* @param	alignment   memory alignment of the block
+		*
+		* @return a pointer to the newly allocated block, or nullptr if the allocator is out of memory
+		*/
+		void* allocate_raw_thread_safe(size_t size, size_t alignment = alignof(std::max_align_t)) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			return allocate_tracked(size, alignment);
+		}
+
+		/**
+		* @brief Deallocates a raw block of memory previously allocated by allocate_raw(), no destructor is called.
+		*
+		* @param	ptr         pointer to the deallocated block
+		*/
+		void deallocate_raw(void* ptr) {
+			deallocate_tracked(ptr);
+		}
+
+		/**
+		* @brief Deallocates a raw block of memory in a thread-safe manner.
+		*
+		* @param	ptr         pointer to the deallocated block
+		*/
+		void deallocate_raw_thread_safe(void* ptr) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			deallocate_tracked(ptr);
+		}
+
+		/**
+		* @brief Grows or shrinks a raw block without moving it, which is possible e.g. for the last allocation
+		* of a linear or stack allocator, or for a free list block followed by enough free memory.
+		*
+		* @param	ptr         pointer to a block previously allocated by allocate_raw() or reallocate_raw()
+		* @param	old_size    current size of the block in bytes, as it was requested
+		* @param	new_size    requested size of the block in bytes
+		*
+		* @return true if the block now has new_size bytes, false if it was left untouched
+		*/
+		bool try_expand_in_place(void* ptr, size_t old_size, size_t new_size) {
+			return expand_in_place_tracked(ptr, old_size, new_size);
+		}
+
+		/**
+		* @brief Grows or shrinks a raw block without moving it in a thread-safe manner.
+		*
+		* @param	ptr         pointer to a block previously allocated by allocate_raw() or reallocate_raw()
+		* @param	old_size    current size of the block in bytes, as it was requested
+		* @param	new_size    requested size of the block in bytes
+		*
+		* @return true if the block now has new_size bytes, false if it was left untouched
+		*/
+		bool try_expand_in_place_thread_safe(void* ptr, size_t old_size, size_t new_size) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			return expand_in_place_tracked(ptr, old_size, new_size);
+		}
+
+		/**
+		* @brief Resizes a raw block, in place whenever possible. Otherwise the block is moved to a newly allocated
+		* one and its bytes are copied, the old block is deallocated (or left for clear() by linear allocators).
+		* A shrunk block never moves.
+		*
+		* @param	ptr         pointer to a block previously allocated by allocate_raw(), nullptr to allocate a new one
+		* @param	old_size    current size of the block in bytes, as it was requested
+		* @param	new_size    requested size of the block in bytes
+		* @param	alignment   memory alignment of the block
+		*
+		* @return a pointer to the resized block, or nullptr if the allocator is out of memory, the block is then left untouched
+		*/
+		void* reallocate_raw(void* ptr, size_t old_size, size_t new_size, size_t alignment = alignof(std::max_align_t)) {
+			return reallocate_tracked(ptr, old_size, new_size, alignment);
+		}
+
+		/**
+		* @brief Resizes a raw block in a thread-safe manner, in place whenever possible.
+		*
+		* @param	ptr         pointer to a block previously allocated by allocate_raw(), nullptr to allocate a new one
+		* @param	old_size    current size of the block in bytes, as it was requested
+		* @param	new_size    requested size of the block in bytes
+		* @param	alignment   memory alignment of the block
+		*
+		* @return a pointer to the resized block, or nullptr if the allocator is out of memory, the block is then left untouched
+		*/
+		void* reallocate_raw_thread_safe(void* ptr, size_t old_size, size_t new_size, size_t alignment = alignof(std::max_align_t)) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			return reallocate_tracked(ptr, old_size, new_size, alignment);
+		}
+
+		/**
+		* @brief Allocates a batch of equally sized raw blocks in a single pass, no constructor is called.
+		*
+		* @param	out         array receiving the pointers to the allocated blocks
+		* @param	count       number of requested blocks
+		* @param	size        size of a single block in bytes
+		* @param	alignment   memory alignment of the blocks
+		*
+		* @return number of blocks allocated, the first ones of out, less than count if the allocator ran out of memory
+		*/
+		size_t allocate_raw_batch(void** out, size_t count, size_t size, size_t alignment = alignof(std::max_align_t)) {
+			return allocate_batch_tracked(out, count, size, alignment);
+		}
+
+		/**
+		* @brief Allocates a batch of equally sized raw blocks in a thread-safe manner, the mutex is locked only once.
+		*
+		* @param	out         array receiving the pointers to the allocated blocks
+		* @param	count       number of requested blocks
+		* @param	size        size of a single block in bytes
+		* @param	alignment   memory alignment of the blocks
+		*
+		* @return number of blocks allocated, the first ones of out, less than count if the allocator ran out of memory
+		*/
+		size_t allocate_raw_batch_thread_safe(void** out, size_t count, size_t size, size_t alignment = alignof(std::max_align_t)) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			return allocate_batch_tracked(out, count, size, alignment);
+		}
+
+		/**
+		* @brief Deallocates a batch of raw blocks in a single pass, no destructor is called.
+		*
+		* @param	blocks      array of pointers to blocks previously allocated by allocate_raw() or allocate_raw_batch()
+		* @param	count       number of blocks
+		*/
+		void deallocate_raw_batch(void** blocks, size_t count) {
+			deallocate_batch_tracked(blocks, count);
+		}
+
+		/**
+		* @brief Deallocates a batch of raw blocks in a thread-safe manner, the mutex is locked only once.
+		*
+		* @param	blocks      array of pointers to blocks previously allocated by allocate_raw() or allocate_raw_batch()
+		* @param	count       number of blocks
+		*/
+		void deallocate_raw_batch_thread_safe(void** blocks, size_t count) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			deallocate_batch_tracked(blocks, count);
+		}
+
+		/**
+		* @brief Allocates a single object of specified class.
+		*
+		* @param	T	template type of the new variable
+		*
+		* @return a pointer to the newly allocated class instance
+		*/
+		template <class T> T* allocate() {
+			return new (allocate_tracked(sizeof(T), alignof(T))) T;
+		}
+
+		/**
+		* @brief Allocates a single object of specified class in a thread-safe manner.
+		*
+		* @param	T	template type of the new variable
+		*
+		* @return a pointer to the newly allocated class instance
+		*/
+		template <class T> T* allocate_thread_safe() {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			return allocate<T>();
+		}
+
+		/**
+		* @brief Allocates a single object of specified class with copy constructor.
+		* 
+		* @param	T	template type of the new variable
+		* @param	t	an instance of class T to be copied to the newly allocated one
+		*
+		* @return a pointer to the newly allocated class instance
+		*/
+		template <class T> T* allocate(const T& t) {
+			return new (allocate_tracked(sizeof(T), alignof(T))) T(t);
+		}
+
+		/**
+		* @brief Allocates a single object of specified class with copy constructor in a thread-safe manner.
+		* 
+		* @param	T	template type of the new variable
+		* @param	t	an instance of class T to be copied to the newly allocated one
+		*
+		* @return a pointer to the newly allocated class instance
+		*/
+		template <class T> T* allocate_thread_safe(const T& t) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			return allocate<T>(t);
+		}
+
+		/**
+		* @brief Deallocates a single object specified by a pointer.
+		* 
+		* @param	T	template type of the deleted variable
+		* @param	object	pointer to a previously allocated object
+		*/
+		template <class T> void deallocate(T& object) {
+			object.~T();
+			deallocate_tracked(&object);
+		}
+
+		/**
+		* @brief Deallocates a single object specified by a pointer in a thread-safe manner.
+		* 
+		* @param	T	template type of the deleted variable
+		* @param	object	pointer to a previously allocated object
+		*/
+		template <class T> void deallocate_thread_safe(T& object) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			deallocate(object);
+		}
+
+		/**
+		* @brief Allocates a batch of objects of specified class in a single pass, every object is default constructed.
+		*
+		* @param	T	template type of the new objects
+		* @param	out	array receiving the pointers to the new objects
+		* @param	n	number of requested objects
+		*
+		* @return number of objects allocated, the first ones of out, less than n if the allocator ran out of memory
+		*/
+		template <class T> size_t allocate_batch(T** out, size_t n) {
+			size_t allocated = allocate_batch_tracked(reinterpret_cast<void**>(out), n, sizeof(T), alignof(T));
+			for (size_t i = 0; i < allocated; ++i)
+				new (out[i]) T;
+
+			return allocated;
+		}
+
+		/**
+		* @brief Allocates a batch of objects of specified class in a thread-safe manner, the mutex is locked only once.
+		*
+		* @param	T	template type of the new objects
+		* @param	out	array receiving the pointers to the new objects
+		* @param	n	number of requested objects
+		*
+		* @return number of objects allocated, the first ones of out, less than n if the allocator ran out of memory
+		*/
+		template <class T> size_t allocate_batch_thread_safe(T** out, size_t n) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			return allocate_batch<T>(out, n);
+		}
+
+		/**
+		* @brief Destroys and deallocates a batch of objects in a single pass.
+		*
+		* @param	T	template type of the deleted objects
+		* @param	in	array of pointers to previously allocated objects
+		* @param	n	number of objects
+		*/
+		template <class T> void deallocate_batch(T** in, size_t n) {
+			for (size_t i = 0; i < n; ++i)
+				in[i]->~T();
+
+			deallocate_batch_tracked(reinterpret_cast<void**>(in), n);
+		}
+
+		/**
+		* @brief Destroys and deallocates a batch of objects in a thread-safe manner, the mutex is locked only once.
+		*
+		* @param	T	template type of the deleted objects
+		* @param	in	array of pointers to previously allocated objects
+		* @param	n	number of objects
+		*/
+		template <class T> void deallocate_batch_thread_safe(T** in, size_t n) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			deallocate_batch(in, n);
+		}
+
+		/**
+		* @brief Resizes a buffer of objects allocated by allocate_raw(length * sizeof(T), alignof(T)) or by a previous
+		* reallocate(), e.g. the storage of a growing builder. It is resized in place whenever possible, otherwise
+		* the objects are moved to a new buffer. The objects past new_length are destroyed, the added ones are default
+		* constructed.
+		*
+		* @param	T           	template type of the objects
+		* @param	objects     	the buffer, nullptr to allocate a new one
+		* @param	old_length  	number of objects in the buffer
+		* @param	new_length  	requested number of objects
+		*
+		* @return a pointer to the resized buffer, or nullptr if the allocator is out of memory, the buffer is then left untouched
+		*/
+		template <class T> T* reallocate(T* objects, size_t old_length, size_t new_length) {
+			throw_assert(new_length > 0, "reallocated length must be larger than 0");
+
+			for (size_t i = new_length; i < old_length; ++i)
+				objects[i].~T();
+
+			T* result = objects;
+			if (objects == nullptr) {
+				result = (T*)allocate_tracked(sizeof(T) * new_length, alignof(T));
+			} else if (new_length > old_length && !expand_in_place_tracked(objects, sizeof(T) * old_length, sizeof(T) * new_length)) {
+				result = (T*)allocate_tracked(sizeof(T) * new_length, alignof(T));
+				if (result == nullptr) return nullptr;
+
+				for (size_t i = 0; i < old_length; ++i) {
+					new (&result[i]) T(std::move(objects[i]));
+					objects[i].~T();
+				}
+
+				if (__can_deallocate_moved(objects, sizeof(T) * old_length))
+					deallocate_tracked(objects);
+			} else if (new_length < old_length) {
+				expand_in_place_tracked(objects, sizeof(T) * old_length, sizeof(T) * new_length);
+			}
+
+			if (result == nullptr) return nullptr;
+
+			for (size_t i = old_length; i < new_length; ++i)
+				new (&result[i]) T;
+
+			return result;
+		}
+
+		/**
+		* @brief Resizes a buffer of objects in a thread-safe manner, in place whenever possible.
+		*
+		* @param	T           	template type of the objects
+		* @param	objects     	the buffer, nullptr to allocate a new one
+		* @param	old_length  	number of objects in the buffer
+		* @param	new_length  	requested number of objects
+		*
+		* @return a pointer to the resized buffer, or nullptr if the allocator is out of memory, the buffer is then left untouched
+		*/
+		template <class T> T* reallocate_thread_safe(T* objects, size_t old_length, size_t new_length) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			return reallocate<T>(objects, old_length, new_length);
+		}
+
+		/**
+		* @brief Allocates an array of objects of specified class. The array length is stored in a header in front
+		* of the array only when deallocate_array() needs it to call the destructors, i.e. unless T is trivially destructible.
+		*
+		* @param	T	template type of the new array
+		* @param	length	size of the array
+		* @param	initialization	how the array elements are initialized, trivial types are never initialized element by element
+		*
+		* @return a pointer to the newly allocated array, or nullptr if the allocator is out of memory
+		*/
+		template <class T> T* allocate_array(size_t length, ArrayInitialization initialization = DEFAULT_INITIALIZED) {
+			throw_assert(length > 0, "allocated array length must be larger than 0");
+
+			const size_t headerSize = get_array_header_size<T>();
+
+			// the header needs the alignment of size_t on top of the alignment of T
+			void* block = allocate_tracked(headerSize + sizeof(T) * length, (headerSize > 0 && alignof(T) < alignof(size_t) ? alignof(size_t) : alignof(T)));
+			if (block == nullptr) return nullptr;
+
+			T* array = (T*)MemoryUtils::add_to_pointer(block, headerSize);
+			if (headerSize > 0)
+				*(((size_t*)array) - 1) = length;
+
+			initialize_array(array, length, initialization);
+			return array;
+		}
+
+		/**
+		* @brief Allocates an array of objects of specified class in a thread-safe manner.
+		* 
+		* @param	T	template type of the new array
+		* @param	length	size of the array
+		* @param	initialization	how the array elements are initialized
+		*
+		* @return a pointer to the newly allocated array, or nullptr if the allocator is out of memory
+		*/
+		template <class T> T* allocate_array_thread_safe(size_t length, ArrayInitialization initialization = DEFAULT_INITIALIZED) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			return allocate_array<T>(length, initialization);
+		}
+
+		/**
+		* @brief Deallocates an array of objects allocated by allocate_array(), the destructors are called only for
+		* types which are not trivially destructible.
+		* 
+		* @param	T	template type of the deleted array
+		* @param	array	a pointer to a previously allocated array
+		*/
+		template <class T> void deallocate_array(T* array) {
+			throw_assert(array != nullptr, "deallocated array pointer must not be null");
+
+			const size_t headerSize = get_array_header_size<T>();
+
+			if constexpr (!std::is_trivially_destructible<T>::value) {
+				size_t length = *(((size_t*)array) - 1);
+				for (size_t i = 0; i < length; ++i)
+					array[i].~T();
+			}
+
+			deallocate_tracked(MemoryUtils::add_to_pointer(array, -headerSize));
+		}
+
+		/**
+		* @brief Deallocates an array of objects allocated by allocate_array() in a thread-safe manner.
+		* 
+		* @param	T	template type of the deleted array
+		* @param	array	a pointer to a previously allocated array
+		*/
+		template <class T> void deallocate_array_thread_safe(T* array) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			deallocate_array(array);
+		}
+
+		/**
+		* @brief Allocates an array of objects of specified class without any length header, the caller keeps the
+		* length and passes it to deallocate_sized_array(). For trivial types, this costs the same as allocate_raw().
+		*
+		* @param	T	template type of the new array
+		* @param	length	size of the array
+		* @param	initialization	how the array elements are initialized, trivial types are never initialized element by element
+		*
+		* @return a pointer to the newly allocated array, or nullptr if the allocator is out of memory
+		*/
+		template <class T> T* allocate_sized_array(size_t length, ArrayInitialization initialization = DEFAULT_INITIALIZED) {
+			throw_assert(length > 0, "allocated array length must be larger than 0");
+
+			T* array = (T*)allocate_tracked(sizeof(T) * length, alignof(T));
+			if (array != nullptr)
+				initialize_array(array, length, initialization);
+
+			return array;
+		}
+
+		/**
+		* @brief Allocates an array of objects of specified class without any length header in a thread-safe manner.
+		*
+		* @param	T	template type of the new array
+		* @param	length	size of the array
+		* @param	initialization	how the array elements are initialized
+		*
+		* @return a pointer to the newly allocated array, or nullptr if the allocator is out of memory
+		*/
+		template <class T> T* allocate_sized_array_thread_safe(size_t length, ArrayInitialization initialization = DEFAULT_INITIALIZED) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			return allocate_sized_array<T>(length, initialization);
+		}
+
+		/**
+		* @brief Deallocates an array of objects allocated by allocate_sized_array(), the destructors are called only
+		* for types which are not trivially destructible.
+		*
+		* @param	T	template type of the deleted array
+		* @param	array	a pointer to a previously allocated array
+		* @param	length	size of the array, as it was allocated
+		*/
+		template <class T> void deallocate_sized_array(T* array, size_t length) {
+			throw_assert(array != nullptr, "deallocated array pointer must not be null");
+
+			if constexpr (!std::is_trivially_destructible<T>::value) {
+				for (size_t i = 0; i < length; ++i)
+					array[i].~T();
+			}
+
+			deallocate_tracked(array);
+		}
+
+		/**
+		* @brief Deallocates an array of objects allocated by allocate_sized_array() in a thread-safe manner.
+		*
+		* @param	T	template type of the deleted array
+		* @param	array	a pointer to a previously allocated array
+		* @param	length	size of the array, as it was allocated
+		*/
+		template <class T> void deallocate_sized_array_thread_safe(T* array, size_t length) {
+			std::lock_guard<std::mutex> lock(m_allocator_mutex);
+			deallocate_sized_array(array, length);
+		}
+
+	private:
+		/**
+		* @brief Returns the size of the array length header in bytes, a multiple of alignof(T) so that the array
+		* stays aligned, or 0 if the length is not needed to deallocate the array.
+		*/
+		template <class T> static constexpr size_t get_array_header_size() {
+			return (std::is_trivially_destructible<T>::value ? 0 : (sizeof(size_t) + alignof(T) - 1) / alignof(T) * alignof(T));
+		}
+
+		/**
+		* @brief Initializes the elements of a newly allocated array, trivial types without any per-element loop.
+		*/
+		template <class T> static void initialize_array(T* array, size_t length, ArrayInitialization initialization) {
+			if (initialization == UNINITIALIZED) return;
+
+			if (initialization == VALUE_INITIALIZED) {
+				if constexpr (std::is_trivially_default_constructible<T>::value)
+					std::memset((void*)array, 0, sizeof(T) * length);
+				else
+					for (size_t i = 0; i < length; ++i)
+						new (&array[i]) T();
+			} else {
+				// default initialization of a trivial type leaves the memory as it is
+				if constexpr (!std::is_trivially_default_constructible<T>::value)
+					for (size_t i = 0; i < length; ++i)
+						new (&array[i]) T;
+			}
+		}
+	};
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,119 @@
+#ifndef SIMPLE_MEMORY_MANAGER_BITMAP_POOL_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_BITMAP_POOL_ALLOCATOR_GUARD
+
+#include <BaseAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A pool of equally sized objects which keeps track of its slots in an occupancy bitmap instead of a free list.
+	* A free slot is found by scanning the bitmap a few words at a time (SSE2/AVX2 where available, tzcnt within
+	* a word), and the lowest free address always wins, which keeps the live objects compact even after heavy churn.
+	*
+	* The bitmap also allows iterating over the live objects in address order with for_each_live(), allocating
+	* several contiguous slots at once and detecting double deallocations. The bitmap is carved from the beginning
+	* of the allocator memory, one bit per slot. Slots need no free list pointer, so they can be smaller than one.
+	*/
+	class BitmapPoolAllocator : public BaseAllocator {
+	private:
+		uint64_t*   m_bitmap;           /// occupancy bitmap, a set bit for every slot in use
+		size_t      m_numWords;         /// number of bitmap words
+		size_t      m_firstFreeWord;    /// the lowest bitmap word which may have a free slot, all words before it are full
+		void*       m_slots;            /// address of the first slot
+		size_t      m_numSlots;         /// number of slots
+		size_t      m_objectSize;       /// size of a single slot in bytes
+		size_t      m_objectAlignment;  /// memory alignment of a single slot
+		size_t      m_slotAlignment;    /// alignment every slot actually has, at least m_objectAlignment
+
+		void* __allocate(size_t, size_t);
+		void __deallocate(void*);
+		void fill_stats(AllocatorStats& stats) const;
+
+		size_t find_free_word(size_t from) const noexcept;
+		size_t find_next_free(size_t slot) const noexcept;
+		size_t find_next_used(size_t slot) const noexcept;
+		bool test_range(size_t first, size_t count, bool used) const noexcept;
+		void set_range(size_t first, size_t count, bool used) noexcept;
+		size_t get_slot_index(const void* ptr) const;
+
+		/// the constructor the others delegate to, the memory is taken from memory_source only when memory_ptr is nullptr
+		BitmapPoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source);
+	public:
+		/**
+		* @brief A regular constructor that allocates a specified number of bytes from system.
+		*
+		* @param	memory_size     	size of the memory used by the allocator in bytes, including the bitmap
+		* @param	object_size     	size of a single slot in bytes, rounded up to the alignment
+		* @param	object_alignment	memory alignment of the stored object type
+		* @param	memory_source   	source of the memory, nullptr for ::operator new
+		*/
+		BitmapPoolAllocator(size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A regular constructor that uses a specified number of bytes from a given memory block.
+		*
+		* @param	memory_ptr      	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size     	size of the memory used by the allocator in bytes, including the bitmap
+		* @param	object_size     	size of a single slot in bytes, rounded up to the alignment
+		* @param	object_alignment	memory alignment of the stored object type
+		*/
+		BitmapPoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment);
+
+		/**
+		* @brief Allocates a number of contiguous slots at once, at the lowest address where they fit. Every slot
+		* counts as a single allocation, so they can be deallocated one by one as well as by deallocate_contiguous().
+		*
+		* @param	count   	number of slots
+		*
+		* @return a pointer to the first slot, or nullptr if there are not enough contiguous free slots
+		*/
+		void* allocate_contiguous(size_t count);
+
+		/**
+		* @brief Deallocates a number of contiguous slots at once.
+		*
+		* @param	ptr     	pointer to the first slot
+		* @param	count   	number of slots
+		*/
+		void deallocate_contiguous(void* ptr, size_t count);
+
+		/**
+		* @brief Calls a function for every live slot in address order, skipping the free ones a whole bitmap word
+		* at a time. The function may deallocate the slot it was called for, but must not allocate.
+		*
+		* @param	function	a function taking the void pointer to the slot
+		*/
+		template <class Function> void for_each_live(Function function) {
+			for (size_t word = 0; word < m_numWords; ++word) {
+				uint64_t bits = m_bitmap[word];
+
+				// the padding bits past the last slot are always set
+				if (word == m_numWords - 1 && m_numSlots % 64 != 0)
+					bits &= ((uint64_t)1 << (m_numSlots % 64)) - 1;
+
+				while (bits != 0) {
+					size_t slot = word * 64 + MemoryUtils::get_trailing_zeros(bits);
+					bits &= bits - 1;
+					function(MemoryUtils::add_to_pointer(m_slots, slot * m_objectSize));
+				}
+			}
+		}
+
+		/**
+		* @brief Checks whether a slot is in use.
+		*
+		* @param	ptr 	pointer to a slot of this allocator
+		*/
+		bool is_live(const void* ptr) const;
+
+		/// size of a single slot getter
+		size_t get_object_size() const noexcept { return m_objectSize; }
+		/// memory alignment of a single slot getter
+		size_t get_object_alignment() const noexcept { return m_objectAlignment; }
+		/// number of slots getter
+		size_t get_num_slots() const noexcept { return m_numSlots; }
+	};
+
+}
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef SIMPLE_MEMORY_MANAGER_BUDDY_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_BUDDY_ALLOCATOR_GUARD
+
+#include <BaseAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* An allocator handing out power-of-two sized blocks. The memory is divided into blocks of the maximum order,
+	* which are recursively split in halves ("buddies") until a block of the requested order is obtained, and
+	* a deallocated block is merged back with its buddy whenever the buddy is free as well. Both operations
+	* take O(max_order - min_order) steps, and no block ever has to be shifted around, which keeps the external
+	* fragmentation bounded.
+	*
+	* There are no per-block headers: the blocks are tracked by two bitmaps with one bit per inner tree node,
+	* one marking split nodes and one holding the XOR of the "is free" state of the node's two children.
+	*
+	* A block is aligned to its size, up to the alignment of the first block (the maximum block size, but at most 4 KiB).
+	* A larger alignment than the requested size is met by a larger block, one the first block lacks returns nullptr.
+	*/
+	class BuddyAllocator : public BaseAllocator {
+	public:
+		static const uint8_t MAX_LEVELS = 48;   /// maximum difference between the maximum and the minimum order + 1
+
+	private:
+		struct FreeBlock;
+
+		void*       m_base;                     /// address of the first block, aligned to the maximum block size or to a page
+		uint8_t     m_minOrder;                 /// binary logarithm of the smallest block size
+		uint8_t     m_maxOrder;                 /// binary logarithm of the largest block size
+		uint8_t     m_numLevels;                /// number of block sizes
+		size_t      m_numRoots;                 /// number of blocks of the maximum order
+		size_t      m_innerNodesPerRoot;        /// number of bits each root block occupies in a bitmap
+		uint64_t*   m_splitBits;                /// a bit per inner node, set if the node is split into two children
+		uint64_t*   m_freePairBits;             /// a bit per inner node, set if exactly one of its children is free
+		FreeBlock*  m_freeLists[MAX_LEVELS];    /// free blocks for each level, level 0 holds the maximum order blocks
+
+		void* __allocate(size_t, size_t);
+		void __deallocate(void*);
+		void fill_stats(AllocatorStats& stats) const;
+
+		size_t get_node(size_t root, uint8_t level, size_t index) const;
+		void push_free_block(void* block, size_t root, uint8_t level, size_t index);
+		void remove_free_block(FreeBlock* block, size_t root, uint8_t level, size_t index);
+
+		/// the constructor the others delegate to, the memory is taken from memory_source only when memory_ptr is nullptr
+		BuddyAllocator(void* memory_ptr, size_t memory_size, uint8_t min_order, uint8_t max_order, MemorySource* memory_source);
+	public:
+		/**
+		* @brief A regular constructor that allocates a specified number of bytes from system.
+		*
+		* Only whole blocks of the maximum order are used, the memory size should therefore be a multiple of it.
+		*
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		* @param	min_order   	binary logarithm of the smallest block size, at least 4
+		* @param	max_order   	binary logarithm of the largest block size
+		* @param	memory_source	source of the memory, nullptr for ::operator new
+		*/
+		BuddyAllocator(size_t memory_size, uint8_t min_order, uint8_t max_order, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A regular constructor that uses a specified number of bytes from a given memory block.
+		*
+		* Only whole blocks of the maximum order are used, the memory size should therefore be a multiple of it.
+		*
+		* @param	memory_ptr  	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		* @param	min_order   	binary logarithm of the smallest block size, at least 4
+		* @param	max_order   	binary logarithm of the largest block size
+		*/
+		BuddyAllocator(void* memory_ptr, size_t memory_size, uint8_t min_order, uint8_t max_order);
+
+		virtual ~BuddyAllocator();
+
+		/// smallest block size getter
+		size_t get_min_block_size() const noexcept { return (size_t)1 << m_minOrder; }
+		/// largest block size getter
+		size_t get_max_block_size() const noexcept { return (size_t)1 << m_maxOrder; }
+		/// number of blocks of the largest size getter
+		size_t get_num_max_blocks() const noexcept { return m_numRoots; }
+	};
+
+}
+
+#endif
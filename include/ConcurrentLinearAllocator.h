@@ -0,0 +1,162 @@
+#ifndef SIMPLE_MEMORY_MANAGER_CONCURRENT_LINEAR_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_CONCURRENT_LINEAR_ALLOCATOR_GUARD
+
+#include <BaseAllocator.h>
+#include <atomic>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A linear allocator that can be shared between threads without any lock. The nearest free address is an
+	* atomic offset: requests aligned to at most BASE_ALIGNMENT have their size rounded up to it and take their
+	* memory with a single fetch_add, larger alignments use a compare-and-swap loop. The allocator cannot grow,
+	* and it cannot deallocate its memory randomly, but rather has to clear it completely.
+	*
+	* A ThreadBuffer reserves sub-blocks of the shared memory for a single thread, so that most allocations are
+	* plain thread-local bumps and only a refill touches the shared offset.
+	*
+	* The regular allocate()/deallocate() methods are thread-safe by themselves, the *_thread_safe variants
+	* work as well but needlessly take the allocator mutex. Since the shared counters are atomic, the
+	* get_used_memory() and get_num_allocations() getters of this class have to be used instead of the
+	* BaseAllocator ones. Only the snapshot values of the statistics are available, and reset_stats() has no effect.
+	*/
+	class ConcurrentLinearAllocator : public BaseAllocator {
+	public:
+		static const size_t BASE_ALIGNMENT = alignof(std::max_align_t);    /// alignment every allocation gets with a single fetch_add
+
+		class ThreadBuffer;
+
+	private:
+		/// offset of the nearest free address from the start of the memory, may run past the end once the memory is exhausted
+		alignas(64) std::atomic<size_t>     m_offset;
+		/// number of active allocations, kept on its own cache line so that it does not contend with the offset
+		alignas(64) std::atomic<size_t>     m_allocated;
+		/// incremented by clear(), so that the thread buffers notice their sub-blocks are gone, read on every buffer allocation
+		alignas(64) std::atomic<size_t>     m_generation;
+		void*       m_base;             /// the start of the memory aligned to BASE_ALIGNMENT
+		size_t      m_capacity;         /// size of the memory from m_base on in bytes
+
+		void* __allocate(size_t, size_t);
+		void __deallocate(void*);
+		void fill_stats(AllocatorStats& stats) const;
+
+		void* bump(size_t size, size_t alignment);
+
+		/// the constructor the others delegate to, the memory is taken from memory_source only when memory_ptr is nullptr
+		ConcurrentLinearAllocator(void* memory_ptr, size_t memory_size, MemorySource* memory_source);
+	public:
+		/**
+		* @brief A regular constructor that allocates a specified number of bytes from system.
+		*
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		* @param	memory_source	source of the memory, nullptr for ::operator new
+		*/
+		ConcurrentLinearAllocator(size_t memory_size, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A regular constructor that uses a specified number of bytes from a given memory block.
+		*
+		* @param	memory_ptr  	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		*/
+		ConcurrentLinearAllocator(void* memory_ptr, size_t memory_size);
+
+		virtual ~ConcurrentLinearAllocator();
+
+		/**
+		* @brief Clears the entire allocator memory. No other thread may allocate in the meantime, the thread
+		* buffers drop their sub-blocks on their next allocation.
+		*/
+		void clear();
+
+		/// memory used by allocator (in bytes) getter, including the unused parts of the thread buffer sub-blocks
+		size_t get_used_memory() const noexcept {
+			size_t offset = m_offset.load(std::memory_order_relaxed);
+			return (offset < m_capacity ? offset : m_capacity);
+		}
+		/// number of active allocations getter, the allocations of a thread buffer are added when it refills or is destroyed
+		size_t get_num_allocations() const noexcept { return m_allocated.load(std::memory_order_relaxed); }
+	};
+
+	/**
+	* A sub-block of a ConcurrentLinearAllocator reserved for a single thread. Allocations are bumped within
+	* the sub-block without any atomic operation, a new sub-block is reserved when it runs out. Requests larger
+	* than a quarter of the sub-block size are taken from the shared allocator directly, so that they do not
+	* waste the rest of the sub-block.
+	*
+	* A thread buffer must only be used by a single thread at a time, and must not outlive its allocator.
+	*/
+	class ConcurrentLinearAllocator::ThreadBuffer {
+	private:
+		ConcurrentLinearAllocator&  m_allocator;        /// the shared allocator the sub-blocks are reserved from
+		size_t      m_blockSize;                        /// size of a single sub-block in bytes
+		void*       m_firstFree;                        /// the nearest free address in the current sub-block
+		void*       m_end;                              /// the end of the current sub-block
+		size_t      m_generation;                       /// generation of the allocator the current sub-block belongs to
+		size_t      m_numAllocations;                   /// allocations not yet added to the shared counter
+
+		ThreadBuffer(const ThreadBuffer&) = delete;     // disable copy-constructor
+
+		bool refill();
+		void flush_counter();
+	public:
+		static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;    /// default size of a sub-block in bytes
+
+		/**
+		* @brief A regular constructor, no memory is reserved until the first allocation.
+		*
+		* @param	allocator   	the shared allocator, it must outlive the buffer
+		* @param	block_size  	size of a single sub-block in bytes
+		*/
+		explicit ThreadBuffer(ConcurrentLinearAllocator& allocator, size_t block_size = DEFAULT_BLOCK_SIZE);
+
+		/**
+		* @brief Destructor, adds the allocations made through the buffer to the shared counter. The memory stays
+		* allocated until the allocator is cleared.
+		*/
+		~ThreadBuffer();
+
+		/**
+		* @brief Allocates a raw block of uninitialized memory, no constructor is called.
+		*
+		* @param	size        size of the block in bytes
+		* @param	alignment   memory alignment of the block
+		*
+		* @return a pointer to the newly allocated block, or nullptr if the allocator is out of memory
+		*/
+		void* allocate_raw(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		/**
+		* @brief Allocates a single object of specified class.
+		*
+		* @param	T	template type of the new variable
+		*
+		* @return a pointer to the newly allocated class instance, or nullptr if the allocator is out of memory
+		*/
+		template <class T> T* allocate() {
+			void* ptr = allocate_raw(sizeof(T), alignof(T));
+			return (ptr != nullptr ? new (ptr) T : nullptr);
+		}
+
+		/**
+		* @brief Allocates a single object of specified class with copy constructor.
+		*
+		* @param	T	template type of the new variable
+		* @param	t	an instance of class T to be copied to the newly allocated one
+		*
+		* @return a pointer to the newly allocated class instance, or nullptr if the allocator is out of memory
+		*/
+		template <class T> T* allocate(const T& t) {
+			void* ptr = allocate_raw(sizeof(T), alignof(T));
+			return (ptr != nullptr ? new (ptr) T(t) : nullptr);
+		}
+
+		/// the shared allocator getter
+		ConcurrentLinearAllocator& get_allocator() noexcept { return m_allocator; }
+		/// sub-block size getter
+		size_t get_block_size() const noexcept { return m_blockSize; }
+	};
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef SIMPLE_MEMORY_MANAGER_CONCURRENT_POOL_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_CONCURRENT_POOL_ALLOCATOR_GUARD
+
+#include <BaseAllocator.h>
+#include <atomic>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A pool allocator that can be shared between threads without any lock. The free list is a lock-free
+	* Treiber stack of slot indices, and the head of the stack carries a version tag which is bumped on every
+	* change, so a thread that got preempted in the middle of a pop cannot be fooled by the ABA problem.
+	*
+	* The regular allocate()/deallocate() methods are thread-safe by themselves, the *_thread_safe variants
+	* work as well but needlessly take the allocator mutex. Since the shared counters are atomic, the
+	* get_used_memory() and get_num_allocations() getters of this class have to be used instead of the
+	* BaseAllocator ones. The statistics are gathered with atomic counters as well, so the request sizes
+	* and padding are not collected, and reset_stats() has no effect.
+	*/
+	class ConcurrentPoolAllocator : public BaseAllocator {
+	private:
+		/// free list head: version tag in the upper 32 bits, index of the first free slot + 1 in the lower 32 bits
+		alignas(64) std::atomic<uint64_t>   m_head;
+		/// number of active allocations, kept on its own cache line so that it does not contend with the head
+		alignas(64) std::atomic<size_t>     m_allocated;
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+		std::atomic<size_t>     m_peakAllocated;        /// high-water mark of the active allocations
+		std::atomic<size_t>     m_totalAllocations;     /// number of successful allocations
+		std::atomic<size_t>     m_totalDeallocations;   /// number of deallocations
+		std::atomic<size_t>     m_failedAllocations;    /// number of allocations which returned nullptr
+#endif
+
+		void*       m_slots;            /// address of the first (aligned) slot
+		size_t      m_objectSize;       /// size of a single slot in bytes
+		size_t      m_objectAlignment;  /// memory alignment of the stored type
+		size_t      m_slotAlignment;    /// alignment every slot actually has, at least m_objectAlignment
+		uint32_t    m_numSlots;         /// total number of slots
+
+		void* __allocate(size_t, size_t);
+		void __deallocate(void*);
+		void fill_stats(AllocatorStats& stats) const;
+
+		inline void* get_slot(uint32_t index) const {
+			return MemoryUtils::add_to_pointer(m_slots, (size_t)index * m_objectSize);
+		}
+
+		/// the constructor the others delegate to, the memory is taken from memory_source only when memory_ptr is nullptr
+		ConcurrentPoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source);
+	public:
+		/**
+		* @brief A regular constructor that creates a concurrent pool with memory size, object size and object alignment explicitely stated.
+		*
+		* @param	memory_size	size of the memory used by the allocator in bytes
+		* @param	object_size	size of a single pool element in bytes, at least 4 bytes, rounded up to the alignment
+		* @param	object_alignment		memory alignment of the stored object type
+		* @param	memory_source	source of the memory, nullptr for ::operator new
+		*/
+		ConcurrentPoolAllocator(size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A regular constructor that creates a concurrent pool with memory size, object size and object alignment explicitely stated.
+		*
+		* @param	memory_ptr	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size	size of the memory used by the allocator in bytes
+		* @param	object_size	size of a single pool element in bytes, at least 4 bytes, rounded up to the alignment
+		* @param	object_alignment		memory alignment of the stored object type
+		*/
+		ConcurrentPoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment);
+
+		virtual ~ConcurrentPoolAllocator();
+
+		/// memory used by allocator (in bytes) getter
+		size_t get_used_memory() const noexcept { return m_allocated.load(std::memory_order_relaxed) * m_objectSize; }
+		/// number of active allocations getter
+		size_t get_num_allocations() const noexcept { return m_allocated.load(std::memory_order_relaxed); }
+		/// size of a single pool element getter
+		size_t get_object_size() const noexcept { return m_objectSize; }
+		/// total number of pool elements getter
+		size_t get_capacity() const noexcept { return m_numSlots; }
+	};
+
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef SIMPLE_MEMORY_MANAGER_FRAME_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_FRAME_ALLOCATOR_GUARD
+
+#include <LinearAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A multi-buffered allocator for per-frame (per-tick) data. It owns a number of equally sized LinearAllocator
+	* buffers and allocates from one of them during a frame, begin_frame() moves on to the next buffer and clears
+	* it in O(1). With K buffers, the data allocated during a frame stays valid for the K - 1 following frames,
+	* e.g. with two buffers the data of the previous frame can still be read. It cannot deallocate its memory
+	* randomly, the same as a LinearAllocator.
+	*
+	* The allocator tracks how much memory every frame used at most, which helps to size the buffers.
+	*/
+	class FrameAllocator : public BaseAllocator {
+	private:
+		struct Frame;
+
+		Frame*      m_frames;               /// all frame buffers
+		size_t      m_numFrames;            /// number of frame buffers
+		size_t      m_frameSize;            /// size of a single frame buffer in bytes
+		size_t      m_currentFrame;         /// index of the buffer allocated from
+		uint64_t    m_frameNumber;          /// number of begin_frame() calls so far
+		size_t      m_lastHighWaterMark;    /// memory used by the last finished frame in bytes
+		size_t      m_peakHighWaterMark;    /// the most memory used by any frame in bytes
+
+		FrameAllocator(const FrameAllocator&) = delete;     // disable copy-constructor
+
+		void* __allocate(size_t, size_t);
+		void __deallocate(void*);
+		bool __try_expand_in_place(void*, size_t, size_t);
+		void fill_stats(AllocatorStats& stats) const;
+
+		/// the constructor the others delegate to, the memory is taken from memory_source only when memory_ptr is nullptr
+		FrameAllocator(void* memory_ptr, size_t frame_size, size_t num_frames, MemorySource* memory_source);
+	public:
+		/**
+		* @brief A regular constructor that allocates the memory of all frame buffers from system.
+		*
+		* @param	frame_size  	size of a single frame buffer in bytes
+		* @param	num_frames  	number of frame buffers, at least 1
+		* @param	memory_source	source of the memory, nullptr for ::operator new
+		*/
+		FrameAllocator(size_t frame_size, size_t num_frames = 2, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A regular constructor that divides a given memory block into the frame buffers.
+		*
+		* @param	memory_ptr  	pointer to an already allocated system memory of num_frames * frame_size bytes
+		* @param	frame_size  	size of a single frame buffer in bytes
+		* @param	num_frames  	number of frame buffers, at least 1
+		*/
+		FrameAllocator(void* memory_ptr, size_t frame_size, size_t num_frames);
+
+		/**
+		* @brief Destructor, the data of all frames is released without any leak warning.
+		*/
+		~FrameAllocator();
+
+		/**
+		* @brief Starts a new frame. The oldest frame buffer is cleared in O(1) and allocated from from now on,
+		* invalidating the data allocated in it K frames ago.
+		*
+		* Not thread-safe, no other thread may allocate while a new frame is started.
+		*/
+		void begin_frame();
+
+		/// number of frame buffers getter
+		size_t get_num_frames() const noexcept { return m_numFrames; }
+		/// size of a single frame buffer getter
+		size_t get_frame_size() const noexcept { return m_frameSize; }
+		/// number of begin_frame() calls getter
+		uint64_t get_frame_number() const noexcept { return m_frameNumber; }
+		/// memory used by the current frame so far getter
+		size_t get_frame_used_memory() const noexcept;
+		/// memory used by the last finished frame getter
+		size_t get_last_high_water_mark() const noexcept { return m_lastHighWaterMark; }
+		/// the most memory used by any finished frame getter
+		size_t get_peak_high_water_mark() const noexcept { return m_peakHighWaterMark; }
+
+		/**
+		* @brief Forgets the memory used by the finished frames, e.g. after a loading screen.
+		*/
+		void reset_high_water_marks() noexcept;
+	};
+
+}
+
+#endif
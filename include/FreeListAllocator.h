@@ -0,0 +1,73 @@
+#ifndef SIMPLE_MEMORY_MANAGER_FREE_LIST_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_FREE_LIST_ALLOCATOR_GUARD
+
+#include <BaseAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A general purpose allocator serving variable sized allocations which can be deallocated in any order.
+	* Every block starts with a small header holding its size and the size of the block physically before it,
+	* so a deallocated block is merged with both of its free neighbours in constant time. Free blocks are kept
+	* in doubly linked lists, the way a block is picked from them is given by the fit policy.
+	*/
+	class FreeListAllocator : public BaseAllocator {
+	public:
+		/**
+		* The strategy used to pick a free block for a new allocation.
+		*/
+		enum FitPolicy {
+			FIRST_FIT,          /// take the first block large enough, fastest but fragments the most
+			BEST_FIT,           /// take the smallest block large enough, searches all free blocks
+			SEGREGATED_FIT      /// keep the free blocks in power-of-two size buckets and take the first fitting one
+		};
+
+		static const size_t NUM_SEGREGATED_LISTS = 32;  /// number of size buckets used by SEGREGATED_FIT
+
+	private:
+		struct BlockHeader;
+		struct FreeBlock;
+
+		FitPolicy   m_policy;                               /// the block selection strategy
+		FreeBlock*  m_freeLists[NUM_SEGREGATED_LISTS];      /// free block lists, only the first one is used by FIRST_FIT and BEST_FIT
+
+		void* __allocate(size_t, size_t);
+		void __deallocate(void*);
+		bool __try_expand_in_place(void*, size_t, size_t);
+		void fill_stats(AllocatorStats& stats) const;
+
+		size_t get_list_index(size_t block_size) const;
+		void insert_free_block(FreeBlock* block, size_t block_size);
+		void remove_free_block(FreeBlock* block, size_t block_size);
+		FreeBlock* find_free_block(size_t size, size_t alignment, size_t& gap);
+
+		/// the constructor the others delegate to, the memory is taken from memory_source only when memory_ptr is nullptr
+		FreeListAllocator(void* memory_ptr, size_t memory_size, FitPolicy policy, MemorySource* memory_source);
+	public:
+		/**
+		* @brief A regular constructor that allocates a specified number of bytes from system.
+		*
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		* @param	policy      	the free block selection strategy
+		* @param	memory_source	source of the memory, nullptr for ::operator new
+		*/
+		FreeListAllocator(size_t memory_size, FitPolicy policy = SEGREGATED_FIT, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A regular constructor that uses a specified number of bytes from a given memory block.
+		*
+		* @param	memory_ptr  	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		* @param	policy      	the free block selection strategy
+		*/
+		FreeListAllocator(void* memory_ptr, size_t memory_size, FitPolicy policy = SEGREGATED_FIT);
+
+		virtual ~FreeListAllocator();
+
+		/// fit policy getter
+		FitPolicy get_policy() const noexcept { return m_policy; }
+	};
+
+}
+
+#endif
@@ -1,44 +1,140 @@
-#ifndef SIMPLE_MEMORY_MANAGER_LINEAR_ALLOCATOR_GUARD
-#define SIMPLE_MEMORY_MANAGER_LINEAR_ALLOCATOR_GUARD
-
-#include <BaseAllocator.h>
-
-namespace SimpleMemoryAllocator {
-
-	/**
-	* An allocator that allocates memory in a linear fashion. Being the simplest, and therefore
-	* the fastest allocator. It cannot deallocate its memory randomly, but rather has to clear it completely.
-	*/
-	class LinearAllocator : public BaseAllocator {
-	private:
-		void* m_firstFree;	/// the nearest free address
-
-		void* __allocate(size_t, uint8_t);
-		void __deallocate(void*);
-	public:
-		/**
-		* @brief A default constructor that allocates a specified number of bytes from system.
-		*
-		* @param	memory_size 	size of the memory used by the allocator in bytes
-		*/
-		LinearAllocator(size_t memory_size);
-
-		/**
-		* @brief A default constructor that allocates a specified number of bytes from given memory block.
-		*
-		* @param	memory_ptr  	pointer to an already allocated system memory to be used by the allocator
-		* @param	memory_size 	size of the memory used by the allocator in bytes
-		*/
-		LinearAllocator(void* memory_ptr, size_t memory_size);
-
-		~LinearAllocator();
-
-		/**
-		* @brief Clears the entire allocator memory. Replaces the __deallocate() function, which cannot be used in this case.
-		*/
-		void clear();
-	};
-
-}
-
+#ifndef SIMPLE_MEMORY_MANAGER_LINEAR_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_LINEAR_ALLOCATOR_GUARD
+
+#include <BaseAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	struct LinearAllocatorChunk;
+
+	/**
+	* An allocator that allocates memory in a linear fashion. Being the simplest, and therefore
+	* the fastest allocator. It cannot deallocate its memory randomly, but rather has to clear it completely.
+	* A growable allocator chains additional chunks of system memory instead of running out of memory.
+	*/
+	class LinearAllocator : public BaseAllocator {
+	private:
+		void* m_firstFree;	/// the nearest free address
+		void* m_end;		/// the end of the memory chunk currently allocated from
+
+		LinearAllocatorChunk*	m_chunks;			/// additional chunks in the order they were added, only used when growable
+		LinearAllocatorChunk*	m_currentChunk;		/// the chunk currently allocated from, null while in the initial memory
+		size_t					m_capacity;			/// total size of the initial memory and all additional chunks in bytes
+		size_t					m_maxCapacity;		/// the cap on the total size when growing, 0 if the allocator cannot grow
+		size_t					m_maxKeptChunks;	/// number of additional chunks kept for reuse by clear()
+
+		void* __allocate(size_t, size_t);
+		void __deallocate(void*);
+		bool __try_expand_in_place(void*, size_t, size_t);
+		void fill_stats(AllocatorStats& stats) const;
+
+		bool grow(size_t size, size_t alignment);
+
+		/// the constructor the others delegate to, the memory is taken from memory_source only when memory_ptr is nullptr
+		LinearAllocator(void* memory_ptr, size_t memory_size, size_t max_memory_size, size_t max_kept_chunks, MemorySource* memory_source);
+		void free_chunks(LinearAllocatorChunk* chunk);
+	public:
+		static const size_t KEEP_ALL_CHUNKS = (size_t)-1;	/// keep every additional chunk on clear()
+
+		/**
+		* A position in the allocator memory returned by get_marker(), everything allocated after it can be
+		* released at once by free_to_marker().
+		*/
+		struct Marker {
+			void*					position;		/// the nearest free address at the time of the marker
+			LinearAllocatorChunk*	chunk;			/// the chunk allocated from at the time of the marker, null for the initial memory
+			size_t					usedMemory;		/// amount of used memory at the time of the marker
+			size_t					numAllocations;	/// number of allocations at the time of the marker
+		};
+
+		/**
+		* @brief A default constructor that allocates a specified number of bytes from system.
+		*
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		* @param	memory_source	source of the memory, nullptr for ::operator new
+		*/
+		LinearAllocator(size_t memory_size, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A default constructor that allocates a specified number of bytes from given memory block.
+		*
+		* @param	memory_ptr  	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		*/
+		LinearAllocator(void* memory_ptr, size_t memory_size);
+
+		/**
+		* @brief A constructor of a growable allocator that allocates a specified number of bytes from system.
+		*
+		* When the memory is full, an additional chunk is allocated from system, each one twice as large as the previous.
+		*
+		* @param	memory_size 	size of the initial memory used by the allocator in bytes
+		* @param	max_memory_size	the cap on the total size of the initial memory and all additional chunks in bytes
+		* @param	max_kept_chunks	number of additional chunks kept by clear() for reuse, the rest is given back to system
+		* @param	memory_source	source of the memory and of the additional chunks, nullptr for ::operator new
+		*/
+		LinearAllocator(size_t memory_size, size_t max_memory_size, size_t max_kept_chunks = KEEP_ALL_CHUNKS, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A constructor of a growable allocator that starts in a given memory block.
+		*
+		* When the memory is full, an additional chunk is allocated from system, each one twice as large as the previous.
+		*
+		* @param	memory_ptr  	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size 	size of the initial memory used by the allocator in bytes
+		* @param	max_memory_size	the cap on the total size of the initial memory and all additional chunks in bytes
+		* @param	max_kept_chunks	number of additional chunks kept by clear() for reuse, the rest is given back to system
+		*/
+		LinearAllocator(void* memory_ptr, size_t memory_size, size_t max_memory_size, size_t max_kept_chunks = KEEP_ALL_CHUNKS);
+
+		~LinearAllocator();
+
+		/**
+		* @brief Clears the entire allocator memory. Replaces the __deallocate() function, which cannot be used in this case.
+		*
+		* A growable allocator starts over in its initial memory and keeps up to max_kept_chunks additional chunks,
+		* so that refilling it to the same size does not allocate any system memory.
+		*/
+		void clear();
+
+		/**
+		* @brief Returns the current position in the allocator memory.
+		*/
+		Marker get_marker() const noexcept;
+
+		/**
+		* @brief Releases everything allocated after a marker at once, in O(1). Markers can be nested, but a marker
+		* is invalidated by releasing to an older marker or by clear().
+		*
+		* Additional chunks added after the marker are kept for reuse, the same as by clear().
+		*
+		* @param	marker	a marker previously returned by get_marker()
+		*/
+		void free_to_marker(const Marker& marker);
+
+		/**
+		* @brief Checks whether a marker can still be released to, i.e. it is not newer than the allocator state and
+		* points to the initial memory or to a chunk in use. A marker invalidated by clear() is only recognized as
+		* long as nothing was allocated past its position since.
+		*
+		* @param	marker	a marker previously returned by get_marker()
+		*/
+		bool is_valid_marker(const Marker& marker) const noexcept;
+
+		/// total size of the initial memory and all additional chunks getter
+		size_t get_capacity() const noexcept { return m_capacity; }
+		/// whether the allocator can grow getter
+		bool is_growable() const noexcept { return m_maxCapacity != 0; }
+	};
+
+	/**
+	* Header stored at the beginning of every additional chunk of a growable LinearAllocator.
+	*/
+	struct LinearAllocatorChunk {
+		LinearAllocatorChunk*	next;	/// next chunk in the chain
+		size_t					size;	/// size of the chunk in bytes, including this header
+	};
+
+}
+
 #endif
\ No newline at end of file
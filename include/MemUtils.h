@@ -1,61 +1,153 @@
-#ifndef SIMPLE_MEMORY_MANAGER_UTILS_GUARD
-#define SIMPLE_MEMORY_MANAGER_UTILS_GUARD
-
-#include <cstddef>
-#include <cstdint>
-#include <memory>
-
-namespace SimpleMemoryAllocator {
-		/**
-		* @brief A namespace encompassing all auxillary functions concerning either memory alignment or any other kind of memory address manipulation.
-		*/
-	namespace MemoryUtils {
-
-		/**
-		* @brief Computes the nearest aligned address.
-		*
-		* @param	address		original address
-		* @param	alignment	type memory alignment size
-		*
-		* @return the nearest aligned memory address
-		*/
-		uintptr_t get_next_aligned_address(void* address, uint8_t alignment);
-
-		/**
-		* @brief Computes the adjustment needed for the nearest aligned address.
-		*
-		* @param	address		original address
-		* @param	alignment	type memory alignment size
-		*
-		* @return the adjustment required to obtain a nearest aligned address in bytes
-		*/
-		uint8_t get_next_address_adjustment(void* address, uint8_t alignment);
-
-		/**
-		* @brief Computes the adjustment needed for the nearest aligned address when using an allocation header.
-		*
-		* @param	address		original address
-		* @param	alignment	type memory alignment size
-		* @param	header_size	size of the allocation header in bytes
-		*
-		* @return the adjustment required to obtain the nearest aligned address in bytes
-		*/
-		uint8_t get_next_address_adjustment_with_header(void* address, uint8_t alignment, uint8_t header_size);
-
-		/**
-		* @brief Performs an arithmetic addition of a number to a memory address.
-		* 
-		* @param	address		original address
-		* @param	add		the added number
-		* 
-		* @return the new address obtained by addition
-		*/
-		void* add_to_pointer(void* address, size_t add);
-	} // namespace MemoryUtils
-
-
-
-} // namespace SimpleMemoryAllocator
-
-
+#ifndef SIMPLE_MEMORY_MANAGER_UTILS_GUARD
+#define SIMPLE_MEMORY_MANAGER_UTILS_GUARD
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace SimpleMemoryAllocator {
+		/**
+		* @brief A namespace encompassing all auxillary functions concerning either memory alignment or any other kind of memory address manipulation.
+		*
+		* They are all defined inline, so that they are inlined into the allocation fast paths.
+		*/
+	namespace MemoryUtils {
+
+		/**
+		* @brief Computes the nearest aligned address.
+		*
+		* @param	address		original address
+		* @param	alignment	type memory alignment size
+		*
+		* @return the nearest aligned memory address
+		*/
+		inline uintptr_t get_next_aligned_address(void* address, size_t alignment) {
+			return (((uintptr_t)(address) + alignment) & ~(alignment - 1));
+		}
+
+		/**
+		* @brief Checks whether an alignment is valid, i.e. a power of two.
+		*
+		* @param	alignment	type memory alignment size
+		*/
+		inline bool is_valid_alignment(size_t alignment) {
+			return alignment != 0 && (alignment & (alignment - 1)) == 0;
+		}
+
+		/**
+		* @brief Rounds a size up to a multiple of an alignment, so that consecutive objects of that size stay aligned.
+		*
+		* @param	size		size in bytes
+		* @param	alignment	type memory alignment size, a power of two
+		*
+		* @return the smallest multiple of alignment not smaller than size
+		*/
+		inline size_t get_aligned_size(size_t size, size_t alignment) {
+			return (size + alignment - 1) & ~(alignment - 1);
+		}
+
+		/**
+		* @brief Computes the alignment shared by all elements of an array, i.e. the largest power of two dividing
+		* both the address of the first element and the element stride.
+		*
+		* @param	first		address of the first element
+		* @param	stride		distance between two consecutive elements in bytes, larger than 0
+		*
+		* @return the alignment every element of the array has
+		*/
+		inline size_t get_guaranteed_alignment(const void* first, size_t stride) {
+			uintptr_t bits = (uintptr_t)first | stride;
+			return (size_t)(bits & (~bits + 1));
+		}
+
+		/**
+		* @brief Computes the adjustment needed for the nearest aligned address.
+		*
+		* @param	address		original address
+		* @param	alignment	type memory alignment size
+		*
+		* @return the adjustment required to obtain a nearest aligned address in bytes
+		*/
+		inline size_t get_next_address_adjustment(void* address, size_t alignment) {
+			// adjustment < alignment, alignment is a power of two
+			return (alignment - ((uintptr_t)(address) & (alignment - 1))) & (alignment - 1);
+		}
+
+		/**
+		* @brief Computes the adjustment needed for the nearest aligned address when using an allocation header.
+		*
+		* @param	address		original address
+		* @param	alignment	type memory alignment size
+		* @param	header_size	size of the allocation header in bytes
+		*
+		* @return the adjustment required to obtain the nearest aligned address in bytes
+		*/
+		inline size_t get_next_address_adjustment_with_header(void* address, size_t alignment, size_t header_size) {
+			size_t adjustment = get_next_address_adjustment(address, alignment);
+			size_t needed_space = header_size;
+
+			if (adjustment < needed_space) {
+				needed_space -= adjustment;
+
+				// increase adjustment to fit header 
+				adjustment += alignment * (needed_space / alignment);
+
+				if (needed_space % alignment > 0) adjustment += alignment;
+			}
+
+			return adjustment;
+		}
+
+		/**
+		* @brief Performs an arithmetic addition of a number to a memory address.
+		* 
+		* @param	address		original address
+		* @param	add		the added number
+		* 
+		* @return the new address obtained by addition
+		*/
+		inline void* add_to_pointer(void* address, size_t add) {
+			return (static_cast<char*>(address) + add);
+		}
+
+		/**
+		* @brief Computes the binary logarithm of a number rounded down.
+		*
+		* @param	value		a number larger than 0
+		*
+		* @return the index of the highest set bit of the value
+		*/
+		inline uint8_t get_log2_floor(size_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+			return (uint8_t)(sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(value));
+#else
+			uint8_t log = 0;
+			while (value >>= 1) ++log;
+			return log;
+#endif
+		}
+
+		/**
+		* @brief Counts the trailing zero bits of a number, compiled to a single tzcnt/bsf instruction where available.
+		*
+		* @param	value		a number larger than 0
+		*
+		* @return the index of the lowest set bit of the value
+		*/
+		inline uint8_t get_trailing_zeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+			return (uint8_t)__builtin_ctzll(value);
+#else
+			uint8_t zeros = 0;
+			while ((value & 1) == 0) { value >>= 1; ++zeros; }
+			return zeros;
+#endif
+		}
+	} // namespace MemoryUtils
+
+
+
+} // namespace SimpleMemoryAllocator
+
+
 #endif
\ No newline at end of file
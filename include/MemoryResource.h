@@ -0,0 +1,233 @@
+#ifndef SIMPLE_MEMORY_MANAGER_MEMORY_RESOURCE_GUARD
+#define SIMPLE_MEMORY_MANAGER_MEMORY_RESOURCE_GUARD
+
+#include <StackAllocator.h>
+#include <memory_resource>
+#include <type_traits>
+#include <new>
+#include <limits>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* @brief A namespace encompassing the helpers shared by the standard library adapters.
+	*/
+	namespace AdapterUtils {
+
+		/**
+		* The way an adapter handles the deallocations requested by a container.
+		*/
+		enum DeallocationMode {
+			DEALLOCATE,             /// pass every deallocation to the allocator
+			IGNORE_DEALLOCATION,    /// ignore deallocations, the memory is released all at once by clear()
+			LIFO_DEALLOCATION       /// deallocate only the block on the top of the stack, ignore the rest
+		};
+
+		/// allocators able to deallocate any block, the linear ones (and frame allocators on begin_frame()) only release all their memory at once
+		inline DeallocationMode get_deallocation_mode(BaseAllocator& allocator) { return (allocator.can_deallocate_blocks() ? DEALLOCATE : IGNORE_DEALLOCATION); }
+		/// stack allocators can only deallocate their top block
+		inline DeallocationMode get_deallocation_mode(StackAllocator&) { return LIFO_DEALLOCATION; }
+
+		/**
+		* @brief Allocates a raw block for an adapter, throwing std::bad_alloc on failure as the standard library expects.
+		*
+		* @param	allocator   	the adapted allocator
+		* @param	bytes       	size of the block in bytes
+		* @param	alignment   	memory alignment of the block
+		* @param	thread_safe 	whether to use the thread-safe allocator methods
+		*
+		* @return a pointer to the newly allocated block
+		*/
+		inline void* allocate(BaseAllocator& allocator, size_t bytes, size_t alignment, bool thread_safe) {
+			if (!MemoryUtils::is_valid_alignment(alignment)) throw std::bad_alloc();
+
+			// containers may ask for empty blocks, the allocators may not
+			if (bytes == 0) bytes = 1;
+
+			void* ptr = (thread_safe ? allocator.allocate_raw_thread_safe(bytes, alignment) : allocator.allocate_raw(bytes, alignment));
+			if (ptr == nullptr) throw std::bad_alloc();
+
+			return ptr;
+		}
+
+		/**
+		* @brief Deallocates a raw block for an adapter according to the deallocation mode.
+		*
+		* @param	allocator   	the adapted allocator
+		* @param	mode        	deallocation mode of the allocator
+		* @param	ptr         	pointer to the deallocated block
+		* @param	bytes       	size of the block in bytes, as it was requested
+		* @param	thread_safe 	whether to use the thread-safe allocator methods
+		*/
+		inline void deallocate(BaseAllocator& allocator, DeallocationMode mode, void* ptr, size_t bytes, bool thread_safe) {
+			if (mode == IGNORE_DEALLOCATION) return;
+
+			std::unique_lock<std::mutex> lock;
+			if (thread_safe) lock = std::unique_lock<std::mutex>(allocator.get_mutex());
+
+			if (mode == LIFO_DEALLOCATION && !static_cast<StackAllocator&>(allocator).is_last_allocation(ptr, bytes == 0 ? 1 : bytes))
+				return;
+
+			allocator.deallocate_raw(ptr);
+		}
+
+	} // namespace AdapterUtils
+
+	/**
+	* A std::pmr::memory_resource backed by any of the allocators, so that the std::pmr containers can use them.
+	*
+	* Deallocations are passed to the allocator whenever it is able to handle them: the allocators unable to
+	* deallocate single blocks (LinearAllocator, ConcurrentLinearAllocator) ignore them and release everything on clear()
+	* (a FrameAllocator on begin_frame()), a StackAllocator only deallocates the block on its top and the
+	* blocks deallocated out of order stay allocated. The allocator must outlive the memory resource.
+	*/
+	class AllocatorMemoryResource : public std::pmr::memory_resource {
+	private:
+		BaseAllocator&                  m_allocator;    /// the adapted allocator
+		AdapterUtils::DeallocationMode  m_mode;         /// the way deallocations are handled
+		bool                            m_threadSafe;   /// whether the thread-safe allocator methods are used
+
+	public:
+		/**
+		* @brief A regular constructor that adapts an allocator.
+		*
+		* @param	allocator   	the adapted allocator
+		* @param	thread_safe 	whether to use the thread-safe allocator methods
+		*/
+		template <class Allocator, class = typename std::enable_if<std::is_base_of<BaseAllocator, Allocator>::value>::type>
+		explicit AllocatorMemoryResource(Allocator& allocator, bool thread_safe = false)
+			: m_allocator(allocator)
+			, m_mode(AdapterUtils::get_deallocation_mode(allocator))
+			, m_threadSafe(thread_safe) { }
+
+		/// adapted allocator getter
+		BaseAllocator& get_allocator() const noexcept { return m_allocator; }
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			return AdapterUtils::allocate(m_allocator, bytes, alignment, m_threadSafe);
+		}
+
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+			AdapterUtils::deallocate(m_allocator, m_mode, ptr, bytes, m_threadSafe);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			const AllocatorMemoryResource* resource = dynamic_cast<const AllocatorMemoryResource*>(&other);
+			return resource != nullptr && &resource->m_allocator == &m_allocator;
+		}
+	};
+
+	/**
+	* A memory source backed by any of the allocators, so that allocators can be nested, e.g. pools carved from
+	* a linear arena. The regions are deallocated the same way as by AllocatorMemoryResource, the allocator must
+	* outlive the memory source.
+	*/
+	class AllocatorMemorySource : public MemorySource {
+	private:
+		BaseAllocator&                  m_allocator;    /// the adapted allocator
+		AdapterUtils::DeallocationMode  m_mode;         /// the way deallocations are handled
+		size_t                          m_alignment;    /// memory alignment of the regions
+		bool                            m_threadSafe;   /// whether the thread-safe allocator methods are used
+
+	public:
+		/**
+		* @brief A regular constructor that adapts an allocator.
+		*
+		* @param	allocator   	the adapted allocator
+		* @param	alignment   	memory alignment of the regions
+		* @param	thread_safe 	whether to use the thread-safe allocator methods
+		*/
+		template <class Allocator, class = typename std::enable_if<std::is_base_of<BaseAllocator, Allocator>::value>::type>
+		explicit AllocatorMemorySource(Allocator& allocator, size_t alignment = alignof(std::max_align_t), bool thread_safe = false)
+			: m_allocator(allocator)
+			, m_mode(AdapterUtils::get_deallocation_mode(allocator))
+			, m_alignment(alignment)
+			, m_threadSafe(thread_safe) { }
+
+		void* allocate_region(size_t size) override {
+			return (m_threadSafe ? m_allocator.allocate_raw_thread_safe(size, m_alignment) : m_allocator.allocate_raw(size, m_alignment));
+		}
+
+		void deallocate_region(void* ptr, size_t size) override {
+			AdapterUtils::deallocate(m_allocator, m_mode, ptr, size, m_threadSafe);
+		}
+
+		/// adapted allocator getter
+		BaseAllocator& get_allocator() const noexcept { return m_allocator; }
+	};
+
+	/**
+	* A stateful allocator meeting the standard Allocator requirements, so that the regular std containers
+	* can use any of the allocators without the virtual calls of std::pmr. Deallocations are handled the same
+	* way as by AllocatorMemoryResource. Copies and rebound copies share the adapted allocator.
+	*
+	* @param	T	the allocated type
+	*/
+	template <class T> class StlAllocator {
+	private:
+		BaseAllocator*                  m_allocator;    /// the adapted allocator
+		AdapterUtils::DeallocationMode  m_mode;         /// the way deallocations are handled
+		bool                            m_threadSafe;   /// whether the thread-safe allocator methods are used
+
+		template <class U> friend class StlAllocator;
+
+	public:
+		typedef T value_type;
+		typedef std::true_type propagate_on_container_copy_assignment;
+		typedef std::true_type propagate_on_container_move_assignment;
+		typedef std::true_type propagate_on_container_swap;
+		typedef std::false_type is_always_equal;
+
+		/**
+		* @brief A regular constructor that adapts an allocator.
+		*
+		* @param	allocator   	the adapted allocator
+		* @param	thread_safe 	whether to use the thread-safe allocator methods
+		*/
+		template <class Allocator, class = typename std::enable_if<std::is_base_of<BaseAllocator, Allocator>::value>::type>
+		StlAllocator(Allocator& allocator, bool thread_safe = false) noexcept
+			: m_allocator(&allocator)
+			, m_mode(AdapterUtils::get_deallocation_mode(allocator))
+			, m_threadSafe(thread_safe) { }
+
+		/**
+		* @brief Rebinding copy constructor, the copy shares the adapted allocator.
+		*/
+		template <class U> StlAllocator(const StlAllocator<U>& other) noexcept
+			: m_allocator(other.m_allocator)
+			, m_mode(other.m_mode)
+			, m_threadSafe(other.m_threadSafe) { }
+
+		/**
+		* @brief Allocates uninitialized memory for an array of objects.
+		*
+		* @param	n	number of objects
+		*
+		* @return a pointer to the allocated memory
+		*/
+		T* allocate(size_t n) {
+			if (n > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+			return static_cast<T*>(AdapterUtils::allocate(*m_allocator, n * sizeof(T), alignof(T), m_threadSafe));
+		}
+
+		/**
+		* @brief Deallocates memory previously allocated by allocate().
+		*
+		* @param	ptr	pointer to the memory
+		* @param	n	number of objects the memory was allocated for
+		*/
+		void deallocate(T* ptr, size_t n) {
+			AdapterUtils::deallocate(*m_allocator, m_mode, ptr, n * sizeof(T), m_threadSafe);
+		}
+
+		/// adapted allocator getter
+		BaseAllocator& get_allocator() const noexcept { return *m_allocator; }
+
+		template <class U> bool operator==(const StlAllocator<U>& other) const noexcept { return m_allocator == other.m_allocator; }
+		template <class U> bool operator!=(const StlAllocator<U>& other) const noexcept { return m_allocator != other.m_allocator; }
+	};
+
+}
+
+#endif
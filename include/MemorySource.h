@@ -0,0 +1,78 @@
+#ifndef SIMPLE_MEMORY_MANAGER_MEMORY_SOURCE_GUARD
+#define SIMPLE_MEMORY_MANAGER_MEMORY_SOURCE_GUARD
+
+#include <cstddef>
+#include <SystemMemory.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* An upstream provider of the large memory regions the allocators manage. An allocator constructed without
+	* a memory pointer takes its memory from a source and gives it back on destruction, growable allocators take
+	* their additional chunks from it as well. Implementing this interface allows custom page sources, and
+	* AllocatorMemorySource allows nesting allocators, e.g. pools carved from a linear arena.
+	*
+	* A source must outlive all allocators using it.
+	*/
+	class MemorySource {
+	public:
+		virtual ~MemorySource() { }
+
+		/**
+		* @brief Obtains a memory region.
+		*
+		* @param	size	size of the region in bytes
+		*
+		* @return a pointer to the region aligned at least to alignof(std::max_align_t), or nullptr if the source is out of memory
+		*/
+		virtual void* allocate_region(size_t size) = 0;
+
+		/**
+		* @brief Returns a memory region previously obtained by allocate_region().
+		*
+		* @param	ptr 	pointer to the region
+		* @param	size	size of the region in bytes, as passed to allocate_region()
+		*/
+		virtual void deallocate_region(void* ptr, size_t size) = 0;
+
+		/**
+		* @brief Returns the source used by allocators which are not given any, a NewDeleteMemorySource.
+		*/
+		static MemorySource& get_default();
+	};
+
+	/**
+	* A memory source using ::operator new and ::operator delete.
+	*/
+	class NewDeleteMemorySource : public MemorySource {
+	public:
+		void* allocate_region(size_t size) override;
+		void deallocate_region(void* ptr, size_t size) override;
+	};
+
+	/**
+	* A memory source mapping the regions directly from the system with SystemMemory::map(), so that they can
+	* be backed by huge pages, pre-faulted and bound to a NUMA node.
+	*/
+	class MmapMemorySource : public MemorySource {
+	private:
+		MmapOptions m_options;      /// options every region is mapped with
+
+	public:
+		/**
+		* @brief A regular constructor.
+		*
+		* @param	options 	options every region is mapped with
+		*/
+		explicit MmapMemorySource(const MmapOptions& options = MmapOptions()) : m_options(options) { }
+
+		void* allocate_region(size_t size) override;
+		void deallocate_region(void* ptr, size_t size) override;
+
+		/// mapping options getter
+		const MmapOptions& get_options() const noexcept { return m_options; }
+	};
+
+}
+
+#endif
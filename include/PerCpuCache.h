@@ -0,0 +1,153 @@
+#ifndef SIMPLE_MEMORY_MANAGER_PER_CPU_CACHE_GUARD
+#define SIMPLE_MEMORY_MANAGER_PER_CPU_CACHE_GUARD
+
+#include <PoolAllocator.h>
+#include <SlabAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	struct PerCpuShard;
+
+	/**
+	* A per-CPU caching front-end for a PoolAllocator or a SlabAllocator shared between threads. It works like
+	* ThreadCache, but the magazines of free blocks belong to a CPU instead of a thread, so the memory they hold
+	* scales with the number of cores rather than with the number of threads, which matters with hundreds of
+	* mostly idle threads. Over a SlabAllocator, every CPU keeps a magazine for each size class.
+	*
+	* The current CPU is read from the rseq area the C library registers for every thread on Linux, or taken from
+	* sched_getcpu() where rseq is not available. A thread may be migrated right after reading it, so every shard
+	* is guarded by a spin lock, which is almost never contended. The allocator mutex is only locked when a
+	* magazine runs empty or overflows, and blocks are then moved between the magazine and the allocator in batches.
+	*
+	* Blocks sitting in magazines are accounted as used memory of the allocator. They are returned to the
+	* allocator when flush() is called or when the cache is destroyed.
+	*/
+	class PerCpuCache {
+	private:
+		BaseAllocator&  m_allocator;        /// the shared allocator the magazines are refilled from and drained to
+		SlabAllocator*  m_slab;             /// the shared allocator if it is a slab allocator, nullptr for a pool
+		size_t          m_objectSize;       /// size of a single pool block in bytes, unused for a slab allocator
+		size_t          m_objectAlignment;  /// alignment every pool block has, unused for a slab allocator
+		size_t          m_numClasses;       /// number of size classes, a single one for a pool
+		size_t          m_batchSize;        /// number of blocks moved between a magazine and the allocator at once
+		size_t          m_numShards;        /// number of shards, one for every possible CPU
+		PerCpuShard*    m_shards;           /// the shards
+
+		PerCpuCache(const PerCpuCache&) = delete;   // disable copy-constructor
+
+		/// the constructor the others delegate to
+		PerCpuCache(BaseAllocator& allocator, SlabAllocator* slab, size_t object_size, size_t object_alignment, size_t num_classes, size_t batch_size);
+
+		PerCpuShard& lock_current_shard();
+		size_t get_class_size(size_t size_class) const noexcept;
+		void refill(PerCpuShard& shard, size_t size_class);
+		void drain(PerCpuShard& shard, size_t size_class, size_t count);
+	public:
+		/**
+		* @brief A regular constructor that creates a caching front-end for a shared pool.
+		*
+		* @param	pool        the shared pool, it must outlive the cache
+		* @param	batch_size  number of blocks moved between a CPU magazine and the pool at once,
+		*                       every magazine holds at most twice as many blocks
+		*/
+		PerCpuCache(PoolAllocator& pool, size_t batch_size = 32);
+
+		/**
+		* @brief A regular constructor that creates a caching front-end for a shared slab allocator, with a magazine
+		* for every size class.
+		*
+		* @param	slab        the shared slab allocator, it must outlive the cache
+		* @param	batch_size  number of blocks moved between a CPU magazine and the slab allocator at once,
+		*                       every magazine holds at most twice as many blocks
+		*/
+		PerCpuCache(SlabAllocator& slab, size_t batch_size = 32);
+
+		/**
+		* @brief Destructor, returns the blocks cached by all CPUs back to the allocator.
+		*
+		* No other thread may use the cache while it is being destroyed.
+		*/
+		~PerCpuCache();
+
+		/**
+		* @brief Allocates a raw block of uninitialized memory from the magazine of the current CPU.
+		*
+		* @param	size        size of the block in bytes
+		* @param	alignment   memory alignment of the block
+		*
+		* @return a pointer to the allocated block, or nullptr if the request fits no block or both the magazine
+		*         and the allocator are empty
+		*/
+		void* allocate_raw(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		/**
+		* @brief Returns a raw block to the magazine of the current CPU.
+		*
+		* @param	ptr         pointer to a block previously allocated from this cache, by any thread on any CPU
+		*/
+		void deallocate_raw(void* ptr);
+
+		/**
+		* @brief Returns the blocks cached by all CPUs back to the allocator.
+		*/
+		void flush();
+
+		/**
+		* @brief Locks every shard and then the allocator mutex, so that no other thread is inside the cache or the
+		* allocator, e.g. right before fork(). The cache must not be used until unlock_all() is called.
+		*/
+		void lock_all();
+
+		/**
+		* @brief Releases the locks taken by lock_all(). In the child process of a fork(), the locks are released by
+		* the only thread left, the one which took them.
+		*/
+		void unlock_all();
+
+		/// the shared allocator getter
+		BaseAllocator& get_allocator() noexcept { return m_allocator; }
+		/// batch size getter
+		size_t get_batch_size() const noexcept { return m_batchSize; }
+		/// number of shards getter
+		size_t get_num_shards() const noexcept { return m_numShards; }
+
+		/**
+		* @brief Allocates a single object of specified class.
+		*
+		* @param	T	template type of the new variable
+		*
+		* @return a pointer to the newly allocated class instance, or nullptr if the allocator is out of memory
+		*/
+		template <class T> T* allocate() {
+			void* ptr = allocate_raw(sizeof(T), alignof(T));
+			return (ptr != nullptr ? new (ptr) T : nullptr);
+		}
+
+		/**
+		* @brief Allocates a single object of specified class with copy constructor.
+		*
+		* @param	T	template type of the new variable
+		* @param	t	an instance of class T to be copied to the newly allocated one
+		*
+		* @return a pointer to the newly allocated class instance, or nullptr if the allocator is out of memory
+		*/
+		template <class T> T* allocate(const T& t) {
+			void* ptr = allocate_raw(sizeof(T), alignof(T));
+			return (ptr != nullptr ? new (ptr) T(t) : nullptr);
+		}
+
+		/**
+		* @brief Deallocates a single object specified by a pointer.
+		*
+		* @param	T	template type of the deleted variable
+		* @param	object	pointer to a previously allocated object
+		*/
+		template <class T> void deallocate(T& object) {
+			object.~T();
+			deallocate_raw(&object);
+		}
+	};
+
+}
+
+#endif
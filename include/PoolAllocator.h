@@ -1,71 +1,148 @@
-#ifndef SIMPLE_MEMORY_MANAGER_POOL_ALLOCATOR_GUARD
-#define SIMPLE_MEMORY_MANAGER_POOL_ALLOCATOR_GUARD
-
-#include <BaseAllocator.h>
-
-namespace SimpleMemoryAllocator {
-
-	/**
-	* An allocator working as a "pool" of equally sized objects. Since the size of the
-	* objects is constant and known in advance, this reduces the memory and processing overhead.
-	* Also negates the bad effect of memory fragmentation, sice every time a block is freed, it is 
-	* guaranteed to be able to hold another one in its place.
-	*/
-	class PoolAllocator : public BaseAllocator {
-	private:
-		void** m_freeList;          /// a linked list of all currectly unused pool elements
-		size_t m_objectSize;        /// size of the stored type
-		uint8_t m_objectAlignment;  /// memory alignment of the stored type
-
-		void* __allocate(size_t, uint8_t);
-		void __deallocate(void*);
-	public:
-		/**
-		* @brief Simplified constructor that creates pool for a specified type with a specified size.
-		
-		* This constructor calls the PoolAllocator(size_t memory_size, size_taobject_size, uint8_t object_slignment) constructor with 
-		* the appropriate arguments derived from the type and pool size.
-		*
-		* @param	T	template type of the pool
-		* @param	pool_size	number of T-sized elements that the pool should fit
-		*/
-		template <class T> PoolAllocator(size_t pool_size);
-
-		/**
-		* @brief Simplified constructor that creates pool for a specified type with a specified size, starting at a specified point in memory.
-		
-		* This constructor calls the PoolAllocator(void* memory_ptr, size_t mamory_size, size_t object_size, uint8_t object_slignment) constructor with 
-		* the appropriate arguments derived from the type and pool size.
-		*
-		* @param	T	template type of the pool
-		* @param	memory_ptr	pointer to an already allocated system memory to be used by the allocator
-		* @param	pool_size	number of T-sized elements that the pool should fit
-		*/
-		template <class T> PoolAllocator(void* memory_ptr, size_t pool_size);
-
-
-		/**
-		* @brief A regular constructor that creates a pool allocator with memory size, object size and object alignment explicitely stated.
-		* 
-		* @param	memory_size	size of the memory used by the allocator in bytes
-		* @param	object_size	size of a single pool element in bytes
-		* @param	object_slignment		memory alignment of the stored object type
-		*/
-		PoolAllocator(size_t memory_size, size_t object_size, uint8_t object_alignment);
-
-		/**
-		* @brief A regular constructor that creates a pool allocator with memory size, object size and object alignment explicitely stated.
-		*
-		* @param	memory_ptr	pointer to an already allocated system memory to be used by the allocator
-		* @param	memory_size	size of the memory used by the allocator in bytes
-		* @param	object_size	size of a single pool element in bytes
-		* @param	object_slignment		memory alignment of the stored object type
-		*/
-		PoolAllocator(void* memory_ptr, size_t memory_size, size_t object_siza, uint8_t object_slignment);
-
-		virtual ~PoolAllocator();
-	};
-
-}
-
+#ifndef SIMPLE_MEMORY_MANAGER_POOL_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_POOL_ALLOCATOR_GUARD
+
+#include <BaseAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	struct PoolAllocatorChunk;
+
+	/**
+	* An allocator working as a "pool" of equally sized objects. Since the size of the
+	* objects is constant and known in advance, this reduces the memory and processing overhead.
+	* Also negates the bad effect of memory fragmentation, sice every time a block is freed, it is 
+	* guaranteed to be able to hold another one in its place.
+	*
+	* Elements which were never used are handed out by bumping a cursor, the free list only holds the deallocated
+	* ones, so creating even a huge pool is O(1) and does not touch its memory. A growable pool adds another
+	* chunk of system memory when it is full.
+	*/
+	class PoolAllocator : public BaseAllocator {
+	private:
+		void** m_freeList;          /// a linked list of all currectly unused pool elements
+		size_t m_objectSize;        /// size of the stored type
+		size_t  m_objectAlignment;  /// memory alignment of the stored type
+		size_t  m_elementAlignment; /// alignment every element actually has, at least m_objectAlignment
+		void* m_nextUnused;         /// the first element of the current chunk which was never used
+		void* m_unusedEnd;          /// the end of the elements of the current chunk
+
+		PoolAllocatorChunk* m_chunks;   /// additional chunks, the most recent first, only used when growable
+		size_t m_capacity;              /// total size of the initial memory and all additional chunks in bytes
+		size_t m_maxCapacity;           /// the cap on the total size when growing, 0 if the pool cannot grow
+
+		void* __allocate(size_t, size_t);
+		void __deallocate(void*);
+		size_t __allocate_batch(void**, size_t, size_t, size_t);
+		void __deallocate_batch(void**, size_t);
+		void fill_stats(AllocatorStats& stats) const;
+
+		void set_unused_range(void* memory_ptr, size_t memory_size);
+		bool grow();
+
+		/// the constructor the others delegate to, the memory is taken from memory_source only when memory_ptr is nullptr
+		PoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment, size_t max_memory_size, MemorySource* memory_source);
+	public:
+		/**
+		* @brief Simplified factory that creates a pool for a specified type with a specified size, e.g.
+		* PoolAllocator pool = PoolAllocator::create<Type>(poolSize);
+		*
+		* The element size is derived from the type, and the memory size from the element size and the pool size.
+		*
+		* @param	T	template type of the pool
+		* @param	pool_size	number of T-sized elements that the pool should fit
+		* @param	memory_source	source of the memory, nullptr for ::operator new
+		*/
+		template <class T> static PoolAllocator create(size_t pool_size, MemorySource* memory_source = nullptr) {
+			return PoolAllocator(nullptr, pool_size * get_element_size<T>() + alignof(T), get_element_size<T>(), alignof(T), 0, memory_source);
+		}
+
+		/**
+		* @brief Simplified factory that creates a pool for a specified type with a specified size, starting at a specified point in memory.
+		*
+		* @param	T	template type of the pool
+		* @param	memory_ptr	pointer to an already allocated system memory of at least pool_size * get_element_size<T>() + alignof(T) bytes
+		* @param	pool_size	number of T-sized elements that the pool should fit
+		*/
+		template <class T> static PoolAllocator create(void* memory_ptr, size_t pool_size) {
+			return PoolAllocator(memory_ptr, pool_size * get_element_size<T>() + alignof(T), get_element_size<T>(), alignof(T), 0, nullptr);
+		}
+
+		/**
+		* @brief Returns the size of a pool element holding an object of a specified type, large enough for the free list pointer.
+		*/
+		template <class T> static constexpr size_t get_element_size() {
+			return (sizeof(T) >= sizeof(void*) ? sizeof(T) : (sizeof(void*) + alignof(T) - 1) / alignof(T) * alignof(T));
+		}
+
+
+		/**
+		* @brief A regular constructor that creates a pool allocator with memory size, object size and object alignment explicitely stated.
+		* 
+		* @param	memory_size	size of the memory used by the allocator in bytes
+		* @param	object_size	size of a single pool element in bytes, rounded up to the alignment
+		* @param	object_slignment		memory alignment of the stored object type
+		* @param	memory_source	source of the memory, nullptr for ::operator new
+		*/
+		PoolAllocator(size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A regular constructor that creates a pool allocator with memory size, object size and object alignment explicitely stated.
+		*
+		* @param	memory_ptr	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size	size of the memory used by the allocator in bytes
+		* @param	object_size	size of a single pool element in bytes, rounded up to the alignment
+		* @param	object_slignment		memory alignment of the stored object type
+		*/
+		PoolAllocator(void* memory_ptr, size_t memory_size, size_t object_siza, size_t object_slignment);
+
+		/**
+		* @brief A constructor of a growable pool allocator that allocates a specified number of bytes from system.
+		*
+		* When the pool is full, an additional chunk is allocated from system, each one twice as large as the previous.
+		*
+		* @param	memory_size	size of the initial memory used by the allocator in bytes
+		* @param	object_size	size of a single pool element in bytes, rounded up to the alignment
+		* @param	object_alignment		memory alignment of the stored object type
+		* @param	max_memory_size	the cap on the total size of the initial memory and all additional chunks in bytes
+		* @param	memory_source	source of the memory and of the additional chunks, nullptr for ::operator new
+		*/
+		PoolAllocator(size_t memory_size, size_t object_size, size_t object_alignment, size_t max_memory_size, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A constructor of a growable pool allocator that starts in a given memory block.
+		*
+		* When the pool is full, an additional chunk is allocated from system, each one twice as large as the previous.
+		*
+		* @param	memory_ptr	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size	size of the initial memory used by the allocator in bytes
+		* @param	object_size	size of a single pool element in bytes, rounded up to the alignment
+		* @param	object_alignment		memory alignment of the stored object type
+		* @param	max_memory_size	the cap on the total size of the initial memory and all additional chunks in bytes
+		*/
+		PoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment, size_t max_memory_size);
+
+		virtual ~PoolAllocator();
+
+		/// size of a single pool element getter
+		size_t get_object_size() const noexcept { return m_objectSize; }
+		/// memory alignment of a single pool element getter
+		size_t get_object_alignment() const noexcept { return m_objectAlignment; }
+		/// the largest alignment a request can ask for, every element is aligned to it
+		size_t get_element_alignment() const noexcept { return m_elementAlignment; }
+		/// total size of the initial memory and all additional chunks getter
+		size_t get_capacity() const noexcept { return m_capacity; }
+		/// whether the pool can grow getter
+		bool is_growable() const noexcept { return m_maxCapacity != 0; }
+	};
+
+	/**
+	* Header stored at the beginning of every additional chunk of a growable PoolAllocator.
+	*/
+	struct PoolAllocatorChunk {
+		PoolAllocatorChunk*	next;	/// next chunk in the chain
+		size_t				size;	/// size of the chunk in bytes, including this header
+	};
+
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef SIMPLE_MEMORY_MANAGER_REMOTE_FREE_POOL_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_REMOTE_FREE_POOL_ALLOCATOR_GUARD
+
+#include <BaseAllocator.h>
+#include <atomic>
+#include <thread>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A pool of equally sized objects owned by a single thread, for producer/consumer workloads where the
+	* objects are allocated by one thread and deallocated by others. Only the owner thread allocates, and its
+	* allocations and deallocations use a plain free list without any atomic operation. A deallocation coming
+	* from any other thread is pushed onto a lock-free multi-producer single-consumer remote free list instead.
+	* The owner takes the whole remote free list at once when its local free list runs empty, before it touches
+	* the never used elements.
+	*
+	* Remotely deallocated elements count as used until the owner reclaims them. The statistics are not
+	* gathered by BaseAllocator, since the deallocations come from several threads. All methods except for the
+	* deallocation ones must be called by the owner thread.
+	*/
+	class RemoteFreePoolAllocator : public BaseAllocator {
+	private:
+		/// the remote free list, pushed to by the foreign threads and taken by the owner all at once
+		alignas(64) std::atomic<void*>  m_remoteFreeList;
+
+		alignas(64) void**  m_freeList;     /// the local free list, only touched by the owner thread
+		void*       m_nextUnused;           /// the first element which was never used
+		void*       m_unusedEnd;            /// the end of the elements
+		size_t      m_objectSize;           /// size of a single pool element in bytes
+		size_t      m_objectAlignment;      /// memory alignment of the stored type
+		size_t      m_elementAlignment;     /// alignment every element actually has, at least m_objectAlignment
+		size_t      m_capacity;             /// number of pool elements
+		std::thread::id m_owner;            /// the thread allowed to allocate
+
+		void* __allocate(size_t, size_t);
+		void __deallocate(void*);
+		void __deallocate_batch(void** blocks, size_t count);
+		void fill_stats(AllocatorStats& stats) const;
+
+		/// the constructor the others delegate to, the memory is taken from memory_source only when memory_ptr is nullptr
+		RemoteFreePoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source);
+	public:
+		/**
+		* @brief A regular constructor that allocates a specified number of bytes from system, the calling thread becomes the owner.
+		*
+		* @param	memory_size     	size of the memory used by the allocator in bytes
+		* @param	object_size     	size of a single pool element in bytes, at least sizeof(void*), rounded up to the alignment
+		* @param	object_alignment	memory alignment of the stored object type
+		* @param	memory_source   	source of the memory, nullptr for ::operator new
+		*/
+		RemoteFreePoolAllocator(size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A regular constructor that uses a specified number of bytes from a given memory block, the calling thread becomes the owner.
+		*
+		* @param	memory_ptr      	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size     	size of the memory used by the allocator in bytes
+		* @param	object_size     	size of a single pool element in bytes, at least sizeof(void*), rounded up to the alignment
+		* @param	object_alignment	memory alignment of the stored object type
+		*/
+		RemoteFreePoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment);
+
+		/**
+		* @brief Destructor, reclaims the remote free list so that only the really leaked elements are reported.
+		*/
+		virtual ~RemoteFreePoolAllocator();
+
+		/**
+		* @brief Moves all remotely deallocated elements to the local free list. This happens automatically when
+		* the local free list runs empty, calling it explicitly only makes the used memory up to date.
+		*
+		* @return number of reclaimed elements
+		*/
+		size_t reclaim_remote_frees();
+
+		/**
+		* @brief Makes the calling thread the owner of the pool. The previous owner must not use the pool anymore.
+		*/
+		void set_owner_thread() { m_owner = std::this_thread::get_id(); }
+
+		/// whether the calling thread is the owner getter
+		bool is_owner_thread() const noexcept { return std::this_thread::get_id() == m_owner; }
+		/// size of a single pool element getter
+		size_t get_object_size() const noexcept { return m_objectSize; }
+		/// memory alignment of a single pool element getter
+		size_t get_object_alignment() const noexcept { return m_objectAlignment; }
+		/// number of pool elements getter
+		size_t get_capacity() const noexcept { return m_capacity; }
+	};
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SIMPLE_MEMORY_MANAGER_SCOPED_ARENA_GUARD
+#define SIMPLE_MEMORY_MANAGER_SCOPED_ARENA_GUARD
+
+#include <LinearAllocator.h>
+#include <StackAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A guard taking a marker of a LinearAllocator or StackAllocator on construction and releasing everything
+	* allocated after it on destruction, so that per-request or per-phase scratch memory is rolled back at once
+	* instead of deallocating each object. Guards can be nested as long as they are destroyed in reverse order,
+	* which the scoping guarantees.
+	*
+	* Destructors of the objects allocated in the scope are not called. If the marker is invalidated within the
+	* scope, e.g. by clear() or by rewinding an outer scope, the destructor leaves the allocator as it is, since it
+	* must not throw; rewind() checks the marker and throws instead.
+	*
+	* @param	Allocator	LinearAllocator, StackAllocator or any allocator providing get_marker(), free_to_marker() and
+	*                   	is_valid_marker(), e.g. their static counterparts
+	*/
+	template <class Allocator> class ScopedArena {
+	private:
+		Allocator&							m_allocator;	/// the guarded allocator
+		typename Allocator::Marker			m_marker;		/// the allocator position at the beginning of the scope
+
+	public:
+		/**
+		* @brief A regular constructor that marks the current position of an allocator.
+		*
+		* @param	allocator	the guarded allocator
+		*/
+		explicit ScopedArena(Allocator& allocator) : m_allocator(allocator), m_marker(allocator.get_marker()) { }
+
+		/**
+		* @brief Releases everything allocated in the scope, unless the marker is no longer valid.
+		*/
+		~ScopedArena() {
+			if (m_allocator.is_valid_marker(m_marker))
+				m_allocator.free_to_marker(m_marker);
+		}
+
+		ScopedArena(const ScopedArena&) = delete;
+		ScopedArena& operator=(const ScopedArena&) = delete;
+
+		/**
+		* @brief Releases everything allocated in the scope so far, the scope remains open. Fails an assertion if the
+		* marker is no longer valid.
+		*/
+		void rewind() { m_allocator.free_to_marker(m_marker); }
+
+		/// guarded allocator getter
+		Allocator& get_allocator() const noexcept { return m_allocator; }
+		/// marker of the beginning of the scope getter
+		const typename Allocator::Marker& get_marker() const noexcept { return m_marker; }
+	};
+
+}
+
+#endif
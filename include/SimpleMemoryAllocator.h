@@ -1,8 +1,24 @@
-#ifndef SIMPLE_MEMORY_MANAGER_MAIN_GUARD
-#define SIMPLE_MEMORY_MANAGER_MAIN_GUARD
-
-#include <LinearAllocator.h>
-#include <PoolAllocator.h>
-#include <StackAllocator.h>
-
+#ifndef SIMPLE_MEMORY_MANAGER_MAIN_GUARD
+#define SIMPLE_MEMORY_MANAGER_MAIN_GUARD
+
+#include <BitmapPoolAllocator.h>
+#include <FrameAllocator.h>
+#include <FreeListAllocator.h>
+#include <LinearAllocator.h>
+#include <MemoryResource.h>
+#include <BuddyAllocator.h>
+#include <ConcurrentLinearAllocator.h>
+#include <ConcurrentPoolAllocator.h>
+#include <PoolAllocator.h>
+#include <RemoteFreePoolAllocator.h>
+#include <ScopedArena.h>
+#include <SlabAllocator.h>
+#include <StackAllocator.h>
+#include <StaticLinearAllocator.h>
+#include <StaticPoolAllocator.h>
+#include <StaticStackAllocator.h>
+#include <PerCpuCache.h>
+#include <ThreadCache.h>
+#include <TypedPool.h>
+
 #endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+#ifndef SIMPLE_MEMORY_MANAGER_SLAB_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_SLAB_ALLOCATOR_GUARD
+
+#include <PoolAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A small-object allocator serving any size up to 4 KiB in O(1). Every request is rounded up to the nearest
+	* of a small set of size classes (8, 16, 32, 48, ... 128 in 16 byte steps, then four classes per doubling
+	* up to 4096), which keeps the internal waste below 25 %. The memory is divided into equally sized slabs,
+	* and each slab in use serves a single size class through its own PoolAllocator. Slabs which become
+	* empty are given back, so that they can be reused by any other size class.
+	*/
+	class SlabAllocator : public BaseAllocator {
+	public:
+		static const size_t NUM_SIZE_CLASSES = 29;      /// number of size classes
+		static const size_t MAX_SIZE = 4096;            /// the largest size class
+
+	private:
+		struct Slab;
+
+		void*       m_slabsStart;                           /// address of the first slab, page aligned
+		size_t      m_slabSize;                             /// size of a single slab in bytes
+		size_t      m_numSlabs;                             /// total number of slabs
+		Slab*       m_slabs;                                /// bookkeeping of every slab
+		size_t      m_freeSlabs;                            /// index of the first unused slab
+		size_t      m_partialSlabs[NUM_SIZE_CLASSES];       /// index of the first slab with free space for every size class
+
+		void* __allocate(size_t, size_t);
+		void __deallocate(void*);
+		void fill_stats(AllocatorStats& stats) const;
+
+		void link_partial_slab(size_t slab);
+		void unlink_partial_slab(size_t slab);
+
+		/// the constructor the others delegate to, the memory is taken from memory_source only when memory_ptr is nullptr
+		SlabAllocator(void* memory_ptr, size_t memory_size, size_t slab_size, MemorySource* memory_source);
+	public:
+		/**
+		* @brief A regular constructor that allocates a specified number of bytes from system.
+		*
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		* @param	slab_size   	size of a single slab in bytes, a multiple of 4096
+		* @param	memory_source	source of the memory, nullptr for ::operator new
+		*/
+		SlabAllocator(size_t memory_size, size_t slab_size = 64 * 1024, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A regular constructor that uses a specified number of bytes from a given memory block.
+		*
+		* @param	memory_ptr  	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		* @param	slab_size   	size of a single slab in bytes, a multiple of 4096
+		*/
+		SlabAllocator(void* memory_ptr, size_t memory_size, size_t slab_size = 64 * 1024);
+
+		virtual ~SlabAllocator();
+
+		/// slab size getter
+		size_t get_slab_size() const noexcept { return m_slabSize; }
+		/// number of slabs getter
+		size_t get_num_slabs() const noexcept { return m_numSlabs; }
+
+		/**
+		* @brief Finds the smallest size class able to hold an object of given size and alignment.
+		*
+		* @param	size        size of the object in bytes
+		* @param	alignment   memory alignment of the object
+		*
+		* @return index of the size class, or NUM_SIZE_CLASSES if the object is too large or no class is aligned enough
+		*/
+		static size_t get_size_class(size_t size, size_t alignment = 0);
+
+		/**
+		* @brief Returns the object size of a size class.
+		*
+		* @param	size_class  index of the size class
+		*
+		* @return size of the objects served by the size class in bytes
+		*/
+		static size_t get_size_class_size(size_t size_class);
+
+		/**
+		* @brief Finds the size class an allocated block belongs to. The block has to stay allocated, as its
+		* slab may serve another size class once it is empty.
+		*
+		* @param	ptr         pointer to a block allocated by this allocator
+		*
+		* @return index of the size class
+		*/
+		size_t get_size_class_of(const void* ptr) const;
+	};
+
+}
+
+#endif
@@ -1,45 +1,94 @@
-#ifndef SIMPLE_MEMORY_MANAGER_STACK_ALLOCATOR_GUARD
-#define SIMPLE_MEMORY_MANAGER_STACK_ALLOCATOR_GUARD
-
-#include <BaseAllocator.h>
-
-namespace SimpleMemoryAllocator {
-
-	/**
-	* An allocator working like a stack. Therefore, all allocated memory must be deallocated
-	* in a LIFO fashion: if you allocated A first and then B, you must first deallocate B before 
-	* deallocating A.
-	*/
-	class StackAllocator : public BaseAllocator {
-	private:
-		void* m_top;            /// pointer to the element on the top of the stack
-		void* m_previousTop;    /// pointer to the element below the element on the top of the stack
-
-		void* __allocate(size_t, uint8_t);
-		void __deallocate(void*);
-	public:
-		/**
-		* @brief A regular constructor that allocates a specified number of bytes from system.
-		* 
-		* @param 	memory_size 	size of the memory used by allocator in bytes
-		*/
-		StackAllocator(size_t memory_size);
-
-		/**
-		* @brief A regular constructor that uses a specified number of bytes from a given memory block.
-		* 
-		* @param	memory_ptr  	pointer to an already allocated system memory to be used by the allocator
-		* @param 	memory_size 	size of the memory used by allocator in bytes	 	
-		*/
-		StackAllocator(void* memory_ptr, size_t memory_size);
-
-		virtual ~StackAllocator();
-	};
-
-	struct StackAllocationHeader {
-		uint8_t adjustment;
-	};
-
-}
-
+#ifndef SIMPLE_MEMORY_MANAGER_STACK_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_STACK_ALLOCATOR_GUARD
+
+#include <BaseAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* An allocator working like a stack. Therefore, all allocated memory must be deallocated
+	* in a LIFO fashion: if you allocated A first and then B, you must first deallocate B before 
+	* deallocating A.
+	*/
+	class StackAllocator : public BaseAllocator {
+	private:
+		void* m_top;            /// pointer to the element on the top of the stack
+		void* m_previousTop;    /// pointer to the element below the element on the top of the stack
+
+		void* __allocate(size_t, size_t);
+		void __deallocate(void*);
+		bool __try_expand_in_place(void*, size_t, size_t);
+		bool __can_deallocate_moved(const void*, size_t) const;
+	public:
+		/**
+		* @brief A regular constructor that allocates a specified number of bytes from system.
+		* 
+		* @param 	memory_size 	size of the memory used by allocator in bytes
+		* @param 	memory_source	source of the memory, nullptr for ::operator new
+		*/
+		StackAllocator(size_t memory_size, MemorySource* memory_source = nullptr);
+
+		/**
+		* @brief A regular constructor that uses a specified number of bytes from a given memory block.
+		* 
+		* @param	memory_ptr  	pointer to an already allocated system memory to be used by the allocator
+		* @param 	memory_size 	size of the memory used by allocator in bytes	 	
+		*/
+		StackAllocator(void* memory_ptr, size_t memory_size);
+
+		virtual ~StackAllocator();
+
+		/**
+		* A position in the stack returned by get_marker(), everything allocated after it can be released at once
+		* by free_to_marker().
+		*/
+		struct Marker {
+			void*	top;			/// the top of the stack at the time of the marker
+			size_t	usedMemory;		/// amount of used memory at the time of the marker
+			size_t	numAllocations;	/// number of allocations at the time of the marker
+		};
+
+		/**
+		* @brief Returns the current top of the stack.
+		*/
+		Marker get_marker() const noexcept { return Marker{ m_top, m_used_memory, m_num_allocations }; }
+
+		/**
+		* @brief Releases everything allocated after a marker at once, in O(1) and without reading the allocation
+		* headers. Markers can be nested, but a marker is invalidated by releasing to an older one.
+		*
+		* @param	marker	a marker previously returned by get_marker()
+		*/
+		void free_to_marker(const Marker& marker);
+
+		/**
+		* @brief Checks whether a marker can still be released to, i.e. it lies between the bottom and the top of the stack.
+		*
+		* @param	marker	a marker previously returned by get_marker()
+		*/
+		bool is_valid_marker(const Marker& marker) const noexcept { return marker.top >= m_start && marker.top <= m_top; }
+
+		/**
+		* @brief Checks whether a block is the one on the top of the stack, i.e. the only one that can be deallocated.
+		*
+		* @param	ptr     	pointer to a previously allocated block
+		* @param	size    	size of the block in bytes, as it was requested
+		*
+		* @return true if the block is on the top of the stack
+		*/
+		bool is_last_allocation(const void* ptr, size_t size) const noexcept {
+			return (const char*)ptr + size == (const char*)m_top;
+		}
+	};
+
+	/**
+	* A header stored right in front of every stack allocation. The adjustment covers the alignment padding and the
+	* header itself, so it needs more than a byte for alignments above 255, but stays smaller than a pointer.
+	*/
+	struct StackAllocationHeader {
+		uint32_t adjustment;
+	};
+
+}
+
 #endif
\ No newline at end of file
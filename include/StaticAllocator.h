@@ -0,0 +1,173 @@
+#ifndef SIMPLE_MEMORY_MANAGER_STATIC_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_STATIC_ALLOCATOR_GUARD
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <iostream>
+#include <AssertException.h>
+#include <MemUtils.h>
+#include <MemorySource.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* The base of the header-only allocators with static dispatch. It offers the same interface methods as
+	* BaseAllocator, but they call the __allocate()/__deallocate() methods of the derived allocator (CRTP) directly
+	* instead of through virtual functions, so that the whole allocation can be inlined into the calling code.
+	*
+	* The static allocators cannot be used through a BaseAllocator reference, e.g. by the standard library adapters
+	* or as a MemorySource. Use the regular allocators wherever the virtual interface is needed.
+	*
+	* @param	Derived	the derived allocator class, which implements __allocate(size_t, size_t) and __deallocate(void*)
+	*/
+	template <class Derived> class StaticAllocator {
+	private:
+		MemorySource*   m_memorySource;     /// the upstream source of the memory
+		bool            m_ownsMemory;       /// whether the memory was taken from the source and is given back on destruction
+		std::mutex      m_mutex;
+
+		StaticAllocator(const StaticAllocator&) = delete;     // disable copy-constructor
+
+		Derived& derived() noexcept { return *static_cast<Derived*>(this); }
+
+	protected:
+		void*       m_start;                /// pointer to the beginning of the allocated memory
+		size_t      m_size;                 /// size of the allocated memory in bytes
+		size_t      m_usedMemory;           /// amount of used memory in bytes
+		size_t      m_numAllocations;       /// allocation counter, increments with allocations and decrements with deallocations
+
+		/**
+		* @brief Standard constructor, initializes the basic necessary allocator data.
+		*
+		* If start is nullptr, it takes the needed memory from the memory source. Throws std::bad_alloc if the source
+		* is out of memory.
+		*
+		* @param	start       	a pointer to the beginning of the allocated memory space
+		* @param	size        	size of the allocated memory space in bytes
+		* @param	memory_source	source of the memory, nullptr for MemorySource::get_default()
+		*/
+		StaticAllocator(void* start, size_t size, MemorySource* memory_source)
+			: m_memorySource(memory_source != nullptr ? memory_source : &MemorySource::get_default())
+			, m_ownsMemory(start == nullptr)
+			, m_start(start)
+			, m_size(size)
+			, m_usedMemory(0)
+			, m_numAllocations(0) {
+
+			if (m_start == nullptr) {
+				m_start = m_memorySource->allocate_region(size);
+				if (m_start == nullptr) throw std::bad_alloc();
+			}
+		}
+
+		/**
+		* @brief Destructor, able to detect nondeallocated memory the same way as BaseAllocator.
+		*/
+		~StaticAllocator() {
+			if (m_numAllocations != 0 || m_usedMemory != 0)
+				std::cerr
+					<< "All memory shoudld be deallocated before destruction, currently leaking "
+					<< m_numAllocations << " allocations with total size of " << m_usedMemory << " bytes.\n";
+
+			if (m_ownsMemory)
+				m_memorySource->deallocate_region(m_start, m_size);
+		}
+
+	public:
+		/// initial memory position getter
+		void* get_start() const noexcept { return m_start; }
+		/// allocator size getter
+		size_t get_size() const noexcept { return m_size; }
+		/// memory used by allocator (in bytes) getter
+		size_t get_used_memory() const noexcept { return m_usedMemory; }
+		/// number of active allocations getter
+		size_t get_num_allocations() const noexcept { return m_numAllocations; }
+		/// allocator mutex getter
+		std::mutex& get_mutex() noexcept { return m_mutex; }
+
+		/**
+		* @brief Allocates a raw block of uninitialized memory, no constructor is called.
+		*
+		* @param	size        size of the block in bytes
+		* @param	alignment   memory alignment of the block
+		*
+		* @return a pointer to the newly allocated block, or nullptr if the allocator is out of memory
+		*/
+		void* allocate_raw(size_t size, size_t alignment = alignof(std::max_align_t)) {
+			return derived().__allocate(size, alignment);
+		}
+
+		/**
+		* @brief Allocates a raw block of uninitialized memory in a thread-safe manner.
+		*
+		* @param	size        size of the block in bytes
+		* @param	alignment   memory alignment of the block
+		*
+		* @return a pointer to the newly allocated block, or nullptr if the allocator is out of memory
+		*/
+		void* allocate_raw_thread_safe(size_t size, size_t alignment = alignof(std::max_align_t)) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return derived().__allocate(size, alignment);
+		}
+
+		/**
+		* @brief Deallocates a raw block of memory previously allocated by allocate_raw(), no destructor is called.
+		*
+		* @param	ptr         pointer to the deallocated block
+		*/
+		void deallocate_raw(void* ptr) {
+			derived().__deallocate(ptr);
+		}
+
+		/**
+		* @brief Deallocates a raw block of memory in a thread-safe manner.
+		*
+		* @param	ptr         pointer to the deallocated block
+		*/
+		void deallocate_raw_thread_safe(void* ptr) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			derived().__deallocate(ptr);
+		}
+
+		/**
+		* @brief Allocates a single object of specified class.
+		*
+		* @param	T	template type of the new variable
+		*
+		* @return a pointer to the newly allocated class instance, or nullptr if the allocator is out of memory
+		*/
+		template <class T> T* allocate() {
+			void* ptr = derived().__allocate(sizeof(T), alignof(T));
+			return (ptr != nullptr ? new (ptr) T : nullptr);
+		}
+
+		/**
+		* @brief Allocates a single object of specified class with copy constructor.
+		*
+		* @param	T	template type of the new variable
+		* @param	t	an instance of class T to be copied to the newly allocated one
+		*
+		* @return a pointer to the newly allocated class instance, or nullptr if the allocator is out of memory
+		*/
+		template <class T> T* allocate(const T& t) {
+			void* ptr = derived().__allocate(sizeof(T), alignof(T));
+			return (ptr != nullptr ? new (ptr) T(t) : nullptr);
+		}
+
+		/**
+		* @brief Deallocates a single object.
+		*
+		* @param	T	template type of the deleted variable
+		* @param	object	a previously allocated object
+		*/
+		template <class T> void deallocate(T& object) {
+			object.~T();
+			derived().__deallocate(&object);
+		}
+	};
+
+}
+
+#endif
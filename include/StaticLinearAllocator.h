@@ -0,0 +1,106 @@
+#ifndef SIMPLE_MEMORY_MANAGER_STATIC_LINEAR_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_STATIC_LINEAR_ALLOCATOR_GUARD
+
+#include <StaticAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A header-only LinearAllocator with static dispatch, so that the bump allocation inlines into the calling code.
+	* It cannot grow, and it cannot deallocate its memory randomly, but rather has to clear it completely.
+	*/
+	class StaticLinearAllocator : public StaticAllocator<StaticLinearAllocator> {
+	private:
+		void* m_firstFree;	/// the nearest free address
+		void* m_end;		/// the end of the memory
+
+		friend class StaticAllocator<StaticLinearAllocator>;
+
+		void* __allocate(size_t size, size_t alignment) {
+			size_t adjustment = MemoryUtils::get_next_address_adjustment(m_firstFree, alignment);
+
+			// don't allocate if we need to allocate more than we have free
+			if ((size_t)((char*)m_end - (char*)m_firstFree) < adjustment + size) return nullptr;
+
+			void* alignedAddress = MemoryUtils::add_to_pointer(m_firstFree, adjustment);
+			m_firstFree = MemoryUtils::add_to_pointer(alignedAddress, size);
+			m_usedMemory += size + adjustment;
+			++m_numAllocations;
+
+			return alignedAddress;
+		}
+
+		void __deallocate(void* ptr) {
+			throw_assert(false, "method deallocate() is not usable in a linear allocator, use method clear() instead");
+		}
+
+	public:
+		/**
+		* A position in the allocator memory returned by get_marker(), everything allocated after it can be
+		* released at once by free_to_marker().
+		*/
+		struct Marker {
+			void*	position;		/// the nearest free address at the time of the marker
+			size_t	usedMemory;		/// amount of used memory at the time of the marker
+			size_t	numAllocations;	/// number of allocations at the time of the marker
+		};
+
+		/**
+		* @brief A default constructor that allocates a specified number of bytes from system.
+		*
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		* @param	memory_source	source of the memory, nullptr for ::operator new
+		*/
+		explicit StaticLinearAllocator(size_t memory_size, MemorySource* memory_source = nullptr)
+			: StaticLinearAllocator(nullptr, memory_size, memory_source) { }
+
+		/**
+		* @brief A default constructor that allocates a specified number of bytes from given memory block.
+		*
+		* @param	memory_ptr  	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		* @param	memory_source	source of the memory when memory_ptr is nullptr, nullptr for ::operator new
+		*/
+		StaticLinearAllocator(void* memory_ptr, size_t memory_size, MemorySource* memory_source = nullptr)
+			: StaticAllocator<StaticLinearAllocator>(memory_ptr, memory_size, memory_source)
+			, m_firstFree(m_start)
+			, m_end(MemoryUtils::add_to_pointer(m_start, memory_size)) { }
+
+		/**
+		* @brief Clears the entire allocator memory.
+		*/
+		void clear() {
+			m_numAllocations = 0;
+			m_usedMemory = 0;
+			m_firstFree = m_start;
+		}
+
+		/**
+		* @brief Returns the current position in the allocator memory.
+		*/
+		Marker get_marker() const noexcept { return Marker{ m_firstFree, m_usedMemory, m_numAllocations }; }
+
+		/**
+		* @brief Releases everything allocated after a marker at once, in O(1).
+		*
+		* @param	marker	a marker previously returned by get_marker()
+		*/
+		void free_to_marker(const Marker& marker) {
+			throw_assert(is_valid_marker(marker), "marker must lie between the beginning of the memory and the nearest free address");
+
+			m_firstFree = marker.position;
+			m_usedMemory = marker.usedMemory;
+			m_numAllocations = marker.numAllocations;
+		}
+
+		/**
+		* @brief Checks whether a marker can still be released to, i.e. it lies between the beginning of the memory and the nearest free address.
+		*
+		* @param	marker	a marker previously returned by get_marker()
+		*/
+		bool is_valid_marker(const Marker& marker) const noexcept { return marker.position >= m_start && marker.position <= m_firstFree; }
+	};
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef SIMPLE_MEMORY_MANAGER_STATIC_POOL_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_STATIC_POOL_ALLOCATOR_GUARD
+
+#include <StaticAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A header-only PoolAllocator with static dispatch, so that the free list pop and push inline into the calling
+	* code. Never used elements are handed out by bumping a cursor, the same as by PoolAllocator. It cannot grow.
+	*/
+	class StaticPoolAllocator : public StaticAllocator<StaticPoolAllocator> {
+	private:
+		void** m_freeList;          /// a linked list of the deallocated pool elements
+		size_t m_objectSize;        /// size of the stored type
+		size_t  m_objectAlignment;  /// memory alignment of the stored type
+		size_t  m_elementAlignment; /// alignment every element actually has, at least m_objectAlignment
+		void* m_nextUnused;         /// the first element which was never used
+		void* m_unusedEnd;          /// the end of the elements
+
+		friend class StaticAllocator<StaticPoolAllocator>;
+
+		void* __allocate(size_t size, size_t alignment) {
+			// a request that does not fit in an element would overwrite the neighbouring one
+			if (size > m_objectSize || alignment > m_elementAlignment) return nullptr;
+
+			void* ptr;
+
+			if (m_freeList != nullptr) {
+				ptr = m_freeList;
+				m_freeList = (void**)(*m_freeList);
+			} else {
+				if (m_nextUnused == m_unusedEnd) return nullptr;
+
+				ptr = m_nextUnused;
+				m_nextUnused = MemoryUtils::add_to_pointer(m_nextUnused, m_objectSize);
+			}
+
+			m_usedMemory += m_objectSize;
+			++m_numAllocations;
+
+			return ptr;
+		}
+
+		void __deallocate(void* ptr) {
+			throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+			*((void**)ptr) = m_freeList;
+			m_freeList = (void**)ptr;
+			m_usedMemory -= m_objectSize;
+			--m_numAllocations;
+		}
+
+	public:
+		/**
+		* @brief A regular constructor that allocates a specified number of bytes from system.
+		*
+		* @param	memory_size     	size of the memory used by the allocator in bytes
+		* @param	object_size     	size of the stored type in bytes, at least sizeof(void*), rounded up to the alignment
+		* @param	object_alignment	memory alignment of the stored type
+		* @param	memory_source   	source of the memory, nullptr for ::operator new
+		*/
+		StaticPoolAllocator(size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source = nullptr)
+			: StaticPoolAllocator(nullptr, memory_size, object_size, object_alignment, memory_source) { }
+
+		/**
+		* @brief A regular constructor that uses a specified number of bytes from a given memory block.
+		*
+		* @param	memory_ptr      	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size     	size of the memory used by the allocator in bytes
+		* @param	object_size     	size of the stored type in bytes, at least sizeof(void*), rounded up to the alignment
+		* @param	object_alignment	memory alignment of the stored type
+		* @param	memory_source   	source of the memory when memory_ptr is nullptr, nullptr for ::operator new
+		*/
+		StaticPoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source = nullptr)
+			: StaticAllocator<StaticPoolAllocator>(memory_ptr, memory_size, memory_source)
+			, m_freeList(nullptr)
+			, m_objectSize(MemoryUtils::get_aligned_size(object_size, object_alignment))
+			, m_objectAlignment(object_alignment) {
+
+			throw_assert(object_size >= sizeof(void*), "pool object size must be able to hold a pointer");
+			throw_assert(MemoryUtils::is_valid_alignment(object_alignment), "pool object alignment must be a power of two");
+
+			// align only the first element, the size is a multiple of the alignment, so the rest is aligned as well
+			size_t adjustment = MemoryUtils::get_next_address_adjustment(m_start, object_alignment);
+			size_t numObjects = (memory_size > adjustment ? (memory_size - adjustment) / m_objectSize : 0);
+			m_nextUnused = MemoryUtils::add_to_pointer(m_start, adjustment);
+			m_unusedEnd = MemoryUtils::add_to_pointer(m_nextUnused, numObjects * m_objectSize);
+
+			// requests up to the alignment all elements share can be served by any element
+			m_elementAlignment = MemoryUtils::get_guaranteed_alignment(m_nextUnused, m_objectSize);
+		}
+
+		/// size of the stored type getter
+		size_t get_object_size() const noexcept { return m_objectSize; }
+		/// memory alignment of the stored type getter
+		size_t get_object_alignment() const noexcept { return m_objectAlignment; }
+	};
+
+}
+
+#endif
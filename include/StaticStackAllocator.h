@@ -0,0 +1,102 @@
+#ifndef SIMPLE_MEMORY_MANAGER_STATIC_STACK_ALLOCATOR_GUARD
+#define SIMPLE_MEMORY_MANAGER_STATIC_STACK_ALLOCATOR_GUARD
+
+#include <StaticAllocator.h>
+#include <StackAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A header-only StackAllocator with static dispatch, so that the allocation and deallocation inline into
+	* the calling code. All allocated memory must be deallocated in a LIFO fashion.
+	*/
+	class StaticStackAllocator : public StaticAllocator<StaticStackAllocator> {
+	private:
+		void* m_top;            /// pointer to the end of the element on the top of the stack
+
+		friend class StaticAllocator<StaticStackAllocator>;
+
+		void* __allocate(size_t size, size_t alignment) {
+			// the header is accessed in place, so it has to be aligned itself
+			if (alignment < alignof(StackAllocationHeader)) alignment = alignof(StackAllocationHeader);
+
+			size_t adjustment = MemoryUtils::get_next_address_adjustment_with_header(m_top, alignment, sizeof(StackAllocationHeader));
+			throw_assert(adjustment <= UINT32_MAX, "alignment is too large for the stack allocation header");
+
+			// don't allocate if we need to allocate more than we have free
+			if (m_usedMemory + size + adjustment > m_size) return nullptr;
+
+			void* alignedAddress = MemoryUtils::add_to_pointer(m_top, adjustment);
+
+			// store allocation header before the actual stored data
+			StackAllocationHeader* header = (StackAllocationHeader*)MemoryUtils::add_to_pointer(alignedAddress, -sizeof(StackAllocationHeader));
+			header->adjustment = (uint32_t)adjustment;
+
+			m_top = MemoryUtils::add_to_pointer(alignedAddress, size);
+			m_usedMemory += size + adjustment;
+			++m_numAllocations;
+
+			return alignedAddress;
+		}
+
+		void __deallocate(void* ptr) {
+			throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+			StackAllocationHeader* header = (StackAllocationHeader*)MemoryUtils::add_to_pointer(ptr, -sizeof(StackAllocationHeader));
+			m_usedMemory -= ((char*)m_top - (char*)ptr + header->adjustment);
+			m_top = MemoryUtils::add_to_pointer(ptr, -(size_t)header->adjustment);
+			--m_numAllocations;
+		}
+
+	public:
+		typedef StackAllocator::Marker Marker;     /// a position in the stack, the same as of StackAllocator
+
+		/**
+		* @brief A regular constructor that allocates a specified number of bytes from system.
+		*
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		* @param	memory_source	source of the memory, nullptr for ::operator new
+		*/
+		explicit StaticStackAllocator(size_t memory_size, MemorySource* memory_source = nullptr)
+			: StaticStackAllocator(nullptr, memory_size, memory_source) { }
+
+		/**
+		* @brief A regular constructor that uses a specified number of bytes from a given memory block.
+		*
+		* @param	memory_ptr  	pointer to an already allocated system memory to be used by the allocator
+		* @param	memory_size 	size of the memory used by the allocator in bytes
+		* @param	memory_source	source of the memory when memory_ptr is nullptr, nullptr for ::operator new
+		*/
+		StaticStackAllocator(void* memory_ptr, size_t memory_size, MemorySource* memory_source = nullptr)
+			: StaticAllocator<StaticStackAllocator>(memory_ptr, memory_size, memory_source)
+			, m_top(m_start) { }
+
+		/**
+		* @brief Returns the current top of the stack.
+		*/
+		Marker get_marker() const noexcept { return Marker{ m_top, m_usedMemory, m_numAllocations }; }
+
+		/**
+		* @brief Releases everything allocated after a marker at once, in O(1).
+		*
+		* @param	marker	a marker previously returned by get_marker()
+		*/
+		void free_to_marker(const Marker& marker) {
+			throw_assert(is_valid_marker(marker), "marker must lie between the bottom and the top of the stack");
+
+			m_top = marker.top;
+			m_usedMemory = marker.usedMemory;
+			m_numAllocations = marker.numAllocations;
+		}
+
+		/**
+		* @brief Checks whether a marker can still be released to, i.e. it lies between the bottom and the top of the stack.
+		*
+		* @param	marker	a marker previously returned by get_marker()
+		*/
+		bool is_valid_marker(const Marker& marker) const noexcept { return marker.top >= m_start && marker.top <= m_top; }
+	};
+
+}
+
+#endif
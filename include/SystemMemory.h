@@ -0,0 +1,70 @@
+#ifndef SIMPLE_MEMORY_MANAGER_SYSTEM_MEMORY_GUARD
+#define SIMPLE_MEMORY_MANAGER_SYSTEM_MEMORY_GUARD
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* Options for mapping the memory of an allocator directly from the operating system with mmap instead of
+	* ::operator new, so that large arenas can use huge pages, be pre-faulted and bound to a NUMA node. They are
+	* only supported on Linux, other systems fall back to ::operator new and ignore them.
+	*/
+	struct MmapOptions {
+		/**
+		* The kind of pages backing the memory.
+		*/
+		enum HugePages {
+			NO_HUGE_PAGES,              /// regular pages
+			TRANSPARENT_HUGE_PAGES,     /// regular pages aligned to the huge page size and advised (MADV_HUGEPAGE) to be merged into huge ones
+			EXPLICIT_HUGE_PAGES         /// pages from the reserved huge page pool (MAP_HUGETLB), mapping fails if the pool is exhausted
+		};
+
+		HugePages   hugePages = NO_HUGE_PAGES;  /// the kind of pages backing the memory
+		size_t      hugePageSize = 0;           /// size of a huge page in bytes (e.g. 2 MiB or 1 GiB), 0 for the system default
+		bool        populate = false;           /// fault all pages in right away, so that the first touch does not pay for it
+		int         numaNode = -1;              /// NUMA node the memory is bound to (mbind), -1 for the default policy
+	};
+
+	/**
+	* @brief A namespace encompassing the functions mapping memory directly from the operating system.
+	*/
+	namespace SystemMemory {
+
+		/**
+		* @brief Maps a block of memory with given options. The size is rounded up to whole pages (huge pages when used).
+		*
+		* Throws std::bad_alloc if the system is out of memory, the same as ::operator new.
+		*
+		* @param	size    	size of the block in bytes
+		* @param	options 	the mapping options
+		*
+		* @return a pointer to the page aligned block
+		*/
+		void* map(size_t size, const MmapOptions& options);
+
+		/**
+		* @brief Unmaps a block previously mapped by map().
+		*
+		* @param	ptr     	pointer to the block
+		* @param	size    	size of the block in bytes, as passed to map()
+		* @param	options 	the options the block was mapped with
+		*/
+		void unmap(void* ptr, size_t size, const MmapOptions& options);
+
+		/**
+		* @brief Returns the size of a regular memory page.
+		*/
+		size_t get_page_size();
+
+		/**
+		* @brief Returns the default size of a huge page, or 0 if the system does not support them.
+		*/
+		size_t get_huge_page_size();
+
+	} // namespace SystemMemory
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef SIMPLE_MEMORY_MANAGER_THREAD_CACHE_GUARD
+#define SIMPLE_MEMORY_MANAGER_THREAD_CACHE_GUARD
+
+#include <PoolAllocator.h>
+
+namespace SimpleMemoryAllocator {
+
+	struct ThreadCacheMagazine;
+
+	/**
+	* A per-thread caching front-end for a PoolAllocator shared between threads. Every thread keeps a small
+	* magazine of free blocks taken from the shared pool, so the common allocation and deallocation path takes
+	* no lock at all. The pool mutex is only locked when a magazine runs empty or overflows, and blocks are then
+	* moved between the magazine and the pool in batches.
+	*
+	* Blocks sitting in magazines are accounted as used memory of the shared pool. Magazines are returned to
+	* the pool when their thread exits, when flush() is called or when the cache is destroyed.
+	*/
+	class ThreadCache {
+	private:
+		PoolAllocator&          m_pool;             /// the shared pool the magazines are refilled from and drained to
+		size_t                  m_objectSize;       /// size of a single block in bytes
+		size_t                  m_objectAlignment;  /// memory alignment of a single block
+		size_t                  m_batchSize;        /// number of blocks moved between a magazine and the pool at once
+		uint64_t                m_id;               /// unique identifier used to find the thread's magazine
+		ThreadCacheMagazine*    m_magazines;        /// all magazines created for this cache, guarded by the magazine registry mutex
+
+		ThreadCache(const ThreadCache&) = delete;   // disable copy-constructor
+
+		ThreadCacheMagazine* get_magazine();
+		ThreadCacheMagazine* create_magazine();
+		void refill(ThreadCacheMagazine* magazine);
+		void drain(ThreadCacheMagazine* magazine, size_t count);
+
+		friend struct ThreadCacheRegistry;
+	public:
+		/**
+		* @brief A regular constructor that creates a caching front-end for a shared pool.
+		*
+		* @param	pool        the shared pool, it must outlive the cache
+		* @param	batch_size  number of blocks moved between a thread magazine and the pool at once,
+		*                       every magazine holds at most twice as many blocks
+		*/
+		ThreadCache(PoolAllocator& pool, size_t batch_size = 32);
+
+		/**
+		* @brief Destructor, returns the blocks cached by all threads back to the pool.
+		*
+		* No other thread may use the cache while it is being destroyed.
+		*/
+		~ThreadCache();
+
+		/**
+		* @brief Allocates a single raw pool block from the calling thread's magazine.
+		*
+		* @return a pointer to the allocated block, or nullptr if both the magazine and the pool are empty
+		*/
+		void* allocate_block();
+
+		/**
+		* @brief Returns a single raw pool block to the calling thread's magazine.
+		*
+		* @param	ptr         pointer to a block previously allocated from this cache, by any thread
+		*/
+		void deallocate_block(void* ptr);
+
+		/**
+		* @brief Returns all blocks cached by the calling thread back to the pool.
+		*/
+		void flush();
+
+		/// the shared pool getter
+		PoolAllocator& get_pool() noexcept { return m_pool; }
+		/// batch size getter
+		size_t get_batch_size() const noexcept { return m_batchSize; }
+
+		/**
+		* @brief Allocates a single object of specified class.
+		*
+		* @param	T	template type of the new variable, it has to fit in a single pool block
+		*
+		* @return a pointer to the newly allocated class instance
+		*/
+		template <class T> T* allocate() {
+			throw_assert(sizeof(T) <= m_objectSize, "allocated type does not fit in a pool block");
+			return new (allocate_block()) T;
+		}
+
+		/**
+		* @brief Allocates a single object of specified class with copy constructor.
+		*
+		* @param	T	template type of the new variable, it has to fit in a single pool block
+		* @param	t	an instance of class T to be copied to the newly allocated one
+		*
+		* @return a pointer to the newly allocated class instance
+		*/
+		template <class T> T* allocate(const T& t) {
+			throw_assert(sizeof(T) <= m_objectSize, "allocated type does not fit in a pool block");
+			return new (allocate_block()) T(t);
+		}
+
+		/**
+		* @brief Deallocates a single object specified by a pointer.
+		*
+		* @param	T	template type of the deleted variable
+		* @param	object	pointer to a previously allocated object
+		*/
+		template <class T> void deallocate(T& object) {
+			object.~T();
+			deallocate_block(&object);
+		}
+	};
+
+}
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef SIMPLE_MEMORY_MANAGER_TYPED_POOL_GUARD
+#define SIMPLE_MEMORY_MANAGER_TYPED_POOL_GUARD
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <AssertException.h>
+#include <MemorySource.h>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* Storage of the TypedPool slots, either inside the pool object itself or taken from a memory source.
+	*
+	* @param	Slot	the slot type
+	* @param	N   	number of slots
+	* @param	Inline	whether the slots are stored inside the pool object
+	*/
+	template <class Slot, size_t N, bool Inline> struct TypedPoolStorage {
+		Slot slots[N];      /// the slots
+
+		constexpr TypedPoolStorage() noexcept : slots() { }
+
+		Slot* get() noexcept { return slots; }
+		const Slot* get() const noexcept { return slots; }
+	};
+
+	template <class Slot, size_t N> struct TypedPoolStorage<Slot, N, false> {
+		static_assert(alignof(Slot) <= alignof(std::max_align_t), "memory sources only guarantee the alignment of std::max_align_t");
+
+		MemorySource*   source;     /// source the slots are taken from
+		Slot*           slots;      /// the slots
+
+		explicit TypedPoolStorage(MemorySource* memory_source = nullptr)
+			: source(memory_source != nullptr ? memory_source : &MemorySource::get_default())
+			, slots(static_cast<Slot*>(source->allocate_region(N * sizeof(Slot)))) {
+
+			if (slots == nullptr) throw std::bad_alloc();
+		}
+
+		~TypedPoolStorage() { source->deallocate_region(slots, N * sizeof(Slot)); }
+
+		TypedPoolStorage(const TypedPoolStorage&) = delete;
+		TypedPoolStorage& operator=(const TypedPoolStorage&) = delete;
+
+		Slot* get() noexcept { return slots; }
+		const Slot* get() const noexcept { return slots; }
+	};
+
+	/**
+	* A pool of N objects of type T with the element size, alignment and capacity fixed at compile time, so that
+	* every address computation is a constant expression. The free list links slots by their index instead of by
+	* a pointer, a uint16_t index for fewer than 65535 slots and a uint32_t one otherwise, so a slot is only as large as
+	* the larger of T and the index.
+	*
+	* By default the slots are stored inside the pool object (alignas(T)), so the pool needs no heap memory at all
+	* and can be a global, a member or a local variable. Its constructor is constexpr, a global or static pool
+	* is therefore constant-initialized, with no static initialization order issues. Otherwise the slots are taken
+	* from a memory source.
+	*
+	* Never used slots are handed out by bumping an index, the free list only holds the deallocated ones.
+	*
+	* @param	T           	type of the stored objects
+	* @param	N           	number of objects the pool holds
+	* @param	InlineStorage	whether the slots are stored inside the pool object or taken from a memory source
+	* @param	Index       	type of the slot indices linking the free list
+	*/
+	template <class T, size_t N, bool InlineStorage = true, class Index = typename std::conditional<(N < 0xFFFF), uint16_t, uint32_t>::type>
+	class TypedPool {
+		static_assert(N > 0, "typed pool must hold at least one object");
+		static_assert(std::is_unsigned<Index>::value, "typed pool index must be an unsigned integer");
+		static_assert(N < (size_t)std::numeric_limits<Index>::max(), "typed pool index type is too small for the number of objects");
+
+	public:
+		static constexpr size_t CAPACITY = N;               /// number of objects the pool holds
+		static constexpr Index NO_SLOT = (Index)N;          /// index terminating the free list
+
+	private:
+		/**
+		* A single pool element, either a free one linked in the free list or a live object.
+		*/
+		union Slot {
+			Index next;                                     /// index of the next free slot
+			alignas(T) unsigned char object[sizeof(T)];     /// storage of the object
+
+			constexpr Slot() noexcept : next(0) { }
+		};
+
+		TypedPoolStorage<Slot, N, InlineStorage> m_storage;    /// the slots
+		Index   m_freeList;             /// index of the first deallocated slot, NO_SLOT if there is none
+		Index   m_nextUnused;           /// index of the first slot which was never used
+		size_t  m_numAllocations;       /// number of live objects
+
+		TypedPool(const TypedPool&) = delete;     // disable copy-constructor
+
+	public:
+		static constexpr size_t SLOT_SIZE = sizeof(Slot);  /// size of a single slot in bytes
+
+		/**
+		* @brief A regular constructor, constexpr for the inline storage.
+		*/
+		constexpr TypedPool() : m_storage(), m_freeList(NO_SLOT), m_nextUnused(0), m_numAllocations(0) { }
+
+		/**
+		* @brief A constructor taking the slots from a given memory source, only available without the inline storage.
+		*
+		* @param	memory_source	source of the slots, nullptr for ::operator new
+		*/
+		template <bool Inline = InlineStorage, class = typename std::enable_if<!Inline>::type>
+		explicit TypedPool(MemorySource* memory_source) : m_storage(memory_source), m_freeList(NO_SLOT), m_nextUnused(0), m_numAllocations(0) { }
+
+		/**
+		* @brief Destructor, able to detect live objects the same way as BaseAllocator. Their destructors are not called.
+		*/
+		~TypedPool() {
+			if (m_numAllocations != 0)
+				std::cerr
+					<< "All memory shoudld be deallocated before destruction, currently leaking "
+					<< m_numAllocations << " allocations with total size of " << m_numAllocations * sizeof(Slot) << " bytes.\n";
+		}
+
+		/**
+		* @brief Allocates a raw slot of uninitialized memory, no constructor is called.
+		*
+		* @return a pointer to the slot, or nullptr if the pool is full
+		*/
+		void* allocate_raw() noexcept {
+			Slot* slots = m_storage.get();
+			Slot* slot;
+
+			if (m_freeList != NO_SLOT) {
+				slot = &slots[m_freeList];
+				m_freeList = slot->next;
+			} else {
+				if (m_nextUnused == NO_SLOT) return nullptr;
+
+				slot = &slots[m_nextUnused++];
+			}
+
+			++m_numAllocations;
+			return slot->object;
+		}
+
+		/**
+		* @brief Deallocates a raw slot previously allocated by allocate_raw(), no destructor is called.
+		*
+		* @param	ptr	pointer to the slot
+		*/
+		void deallocate_raw(void* ptr) {
+			throw_assert(owns(ptr), "deallocated pointer must belong to the pool");
+
+			Slot* slot = reinterpret_cast<Slot*>(ptr);
+			slot->next = m_freeList;
+			m_freeList = (Index)(slot - m_storage.get());
+			--m_numAllocations;
+		}
+
+		/**
+		* @brief Allocates a single object, constructed with the given arguments.
+		*
+		* @param	args	arguments of the object constructor
+		*
+		* @return a pointer to the new object, or nullptr if the pool is full
+		*/
+		template <class... Args> T* allocate(Args&&... args) {
+			void* ptr = allocate_raw();
+			return (ptr != nullptr ? new (ptr) T(std::forward<Args>(args)...) : nullptr);
+		}
+
+		/**
+		* @brief Destroys and deallocates a single object.
+		*
+		* @param	object	an object previously allocated by allocate()
+		*/
+		void deallocate(T& object) {
+			object.~T();
+			deallocate_raw(&object);
+		}
+
+		/**
+		* @brief Checks whether a pointer points to a slot of this pool.
+		*/
+		bool owns(const void* ptr) const noexcept {
+			const Slot* slots = m_storage.get();
+			uintptr_t address = (uintptr_t)ptr;
+
+			return address >= (uintptr_t)slots && address < (uintptr_t)(slots + N) && (address - (uintptr_t)slots) % sizeof(Slot) == 0;
+		}
+
+		/**
+		* @brief Returns the index of an object, usable as a compact handle.
+		*
+		* @param	object	an object allocated from this pool
+		*/
+		Index get_index(const T* object) const noexcept { return (Index)(reinterpret_cast<const Slot*>(object) - m_storage.get()); }
+
+		/**
+		* @brief Returns the object stored at an index previously obtained by get_index().
+		*/
+		T* get_object(Index index) noexcept { return reinterpret_cast<T*>(m_storage.get()[index].object); }
+
+		/// number of live objects getter
+		size_t get_num_allocations() const noexcept { return m_numAllocations; }
+		/// memory used by the live objects in bytes getter
+		size_t get_used_memory() const noexcept { return m_numAllocations * sizeof(Slot); }
+		/// whether the pool is full getter
+		bool is_full() const noexcept { return m_freeList == NO_SLOT && m_nextUnused == NO_SLOT; }
+	};
+
+}
+
+#endif
@@ -0,0 +1,329 @@
+#include <PerCpuCache.h>
+#include <SlabAllocator.h>
+#include <SystemMemory.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*
+* A drop-in replacement of the C and C++ heap, to be loaded with LD_PRELOAD. Requests up to
+* SlabAllocator::MAX_SIZE are served by a SlabAllocator, whose size classes are PoolAllocators, through a
+* PerCpuCache. Larger requests, larger alignments and everything requested before the allocators are set up
+* are mapped directly with mmap and carry a small header in front of the block.
+*
+* The slab arena is reserved as a single mapping of SIMPLE_MEMORY_ALLOCATOR_ARENA_MB MiB (1 GiB by default),
+* its pages are only faulted in when they are used. Once it is exhausted, small requests are mapped as well.
+*/
+
+using namespace SimpleMemoryAllocator;
+
+namespace {
+	const size_t DEFAULT_ARENA_SIZE = (size_t)1024 * 1024 * 1024;
+	const size_t SLAB_SIZE = 256 * 1024;        // larger slabs keep the slab bookkeeping of the arena small
+	const size_t BATCH_SIZE = 16;
+	const size_t MIN_ALIGNMENT = alignof(std::max_align_t);
+
+	enum State { UNINITIALIZED, INITIALIZING, READY };
+
+	/**
+	* Header in front of every mapped block.
+	*/
+	struct MappedBlockHeader {
+		void*       mapping;        /// start of the mapping
+		size_t      mappingSize;    /// size of the mapping in bytes
+	};
+
+	// all of them are constant-initialized, so they are usable before any static constructor has run
+	std::atomic<int>    g_state(UNINITIALIZED);
+	alignas(SlabAllocator) unsigned char    g_slabStorage[sizeof(SlabAllocator)];
+	alignas(PerCpuCache) unsigned char      g_cacheStorage[sizeof(PerCpuCache)];
+	SlabAllocator*      g_slab = nullptr;
+	PerCpuCache*        g_cache = nullptr;
+	char*               g_arenaStart = nullptr;
+	char*               g_arenaEnd = nullptr;
+
+	inline size_t round_up(size_t value, size_t multiple) {
+		return (value + multiple - 1) / multiple * multiple;
+	}
+
+	// the arena is set up before the state becomes ready, and never goes away
+	inline bool is_in_arena(const void* ptr) {
+		return g_state.load(std::memory_order_acquire) == READY && (const char*)ptr >= g_arenaStart && (const char*)ptr < g_arenaEnd;
+	}
+
+	inline MappedBlockHeader* get_header(void* ptr) {
+		return (MappedBlockHeader*)ptr - 1;
+	}
+
+	void* allocate_mapped(size_t size, size_t alignment) {
+		const size_t pageSize = SystemMemory::get_page_size();
+
+		if (size > SIZE_MAX / 4 || alignment > SIZE_MAX / 4) return nullptr;
+		size_t headerSpace = round_up(sizeof(MappedBlockHeader), alignment);
+
+		// the mapping is page aligned, a larger alignment needs room to move the block forward
+		size_t mappingSize = round_up(headerSpace + size + (alignment > pageSize ? alignment : 0), pageSize);
+		void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (mapping == MAP_FAILED) return nullptr;
+
+		void* ptr = (void*)round_up((uintptr_t)mapping + sizeof(MappedBlockHeader), alignment);
+		get_header(ptr)->mapping = mapping;
+		get_header(ptr)->mappingSize = mappingSize;
+
+		return ptr;
+	}
+
+	inline void deallocate_mapped(void* ptr) {
+		MappedBlockHeader* header = get_header(ptr);
+		munmap(header->mapping, header->mappingSize);
+	}
+
+	inline size_t get_mapped_usable_size(void* ptr) {
+		MappedBlockHeader* header = get_header(ptr);
+		return (size_t)((char*)header->mapping + header->mappingSize - (char*)ptr);
+	}
+
+	// a thread forking while another one is inside the allocator would leave the child with a lock nobody
+	// releases, so all of them are taken before fork() and released in both processes afterwards
+	void lock_before_fork() {
+		g_cache->lock_all();
+	}
+
+	void unlock_after_fork() {
+		g_cache->unlock_all();
+	}
+
+	// called by the first allocating thread, the allocations made meanwhile (including its own) are mapped
+	void initialize() {
+		size_t arenaSize = DEFAULT_ARENA_SIZE;
+		if (const char* arenaMiB = getenv("SIMPLE_MEMORY_ALLOCATOR_ARENA_MB")) {
+			size_t size = (size_t)strtoull(arenaMiB, nullptr, 10) * 1024 * 1024;
+			if (size >= SLAB_SIZE * 2)
+				arenaSize = size;
+		}
+
+		// only reserved, the pages are faulted in by the slabs in use
+		void* arena = mmap(nullptr, arenaSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (arena != MAP_FAILED) {
+			g_slab = new (g_slabStorage) SlabAllocator(arena, arenaSize, SLAB_SIZE);
+			g_cache = new (g_cacheStorage) PerCpuCache(*g_slab, BATCH_SIZE);
+			g_arenaStart = (char*)arena;
+			g_arenaEnd = (char*)arena + arenaSize;
+
+			// registering may allocate, which is mapped until the state is ready
+			pthread_atfork(lock_before_fork, unlock_after_fork, unlock_after_fork);
+		}
+
+		// without the arena, everything is mapped
+		g_state.store(READY, std::memory_order_release);
+	}
+
+	void* allocate(size_t size, size_t alignment) {
+		if (size == 0) size = 1;
+		if (alignment < MIN_ALIGNMENT) alignment = MIN_ALIGNMENT;
+
+		int state = g_state.load(std::memory_order_acquire);
+		if (state != READY) {
+			int expected = UNINITIALIZED;
+			if (state == UNINITIALIZED && g_state.compare_exchange_strong(expected, INITIALIZING, std::memory_order_acquire)) {
+				initialize();
+			} else if (g_state.load(std::memory_order_acquire) != READY) {
+				return allocate_mapped(size, alignment);
+			}
+		}
+
+		if (g_cache != nullptr && SlabAllocator::get_size_class(size, alignment) < SlabAllocator::NUM_SIZE_CLASSES) {
+			void* ptr = g_cache->allocate_raw(size, alignment);
+			if (ptr != nullptr) return ptr;
+		}
+
+		return allocate_mapped(size, alignment);
+	}
+
+	void deallocate(void* ptr) {
+		if (ptr == nullptr) return;
+
+		if (is_in_arena(ptr))
+			g_cache->deallocate_raw(ptr);
+		else
+			deallocate_mapped(ptr);
+	}
+
+	size_t get_usable_size(void* ptr) {
+		if (ptr == nullptr) return 0;
+
+		if (is_in_arena(ptr))
+			return SlabAllocator::get_size_class_size(g_slab->get_size_class_of(ptr));
+
+		return get_mapped_usable_size(ptr);
+	}
+
+	void* reallocate(void* ptr, size_t size) {
+		if (ptr == nullptr) return allocate(size, MIN_ALIGNMENT);
+		if (size == 0) {
+			deallocate(ptr);
+			return nullptr;
+		}
+
+		bool mapped = !is_in_arena(ptr);
+		size_t usableSize = get_usable_size(ptr);
+
+		// keep the block unless it would waste more than half of it
+		if (size <= usableSize && size > usableSize / 2) return ptr;
+
+		// a large block with the default alignment is remapped by the kernel instead of copied
+		if (mapped && size > SlabAllocator::MAX_SIZE && (char*)ptr - (char*)get_header(ptr)->mapping == sizeof(MappedBlockHeader)) {
+			if (size > SIZE_MAX / 4) return nullptr;
+
+			MappedBlockHeader* header = get_header(ptr);
+			size_t mappingSize = round_up(sizeof(MappedBlockHeader) + size, SystemMemory::get_page_size());
+			void* mapping = mremap(header->mapping, header->mappingSize, mappingSize, MREMAP_MAYMOVE);
+			if (mapping == MAP_FAILED) return nullptr;
+
+			header = (MappedBlockHeader*)mapping;
+			header->mapping = mapping;
+			header->mappingSize = mappingSize;
+
+			return header + 1;
+		}
+
+		void* newPtr = allocate(size, MIN_ALIGNMENT);
+		if (newPtr == nullptr) return nullptr;
+
+		std::memcpy(newPtr, ptr, (size < usableSize ? size : usableSize));
+		deallocate(ptr);
+
+		return newPtr;
+	}
+
+	inline bool is_valid_alignment(size_t alignment) {
+		return alignment != 0 && (alignment & (alignment - 1)) == 0;
+	}
+
+	void* allocate_or_throw(size_t size, size_t alignment) {
+		for (;;) {
+			void* ptr = allocate(size, alignment);
+			if (ptr != nullptr) return ptr;
+
+			std::new_handler handler = std::get_new_handler();
+			if (handler == nullptr) throw std::bad_alloc();
+			handler();
+		}
+	}
+}
+
+extern "C" {
+
+	void* malloc(size_t size) {
+		void* ptr = allocate(size, MIN_ALIGNMENT);
+		if (ptr == nullptr) errno = ENOMEM;
+		return ptr;
+	}
+
+	void free(void* ptr) {
+		deallocate(ptr);
+	}
+
+	void* calloc(size_t count, size_t size) {
+		size_t bytes;
+		if (__builtin_mul_overflow(count, size, &bytes)) {
+			errno = ENOMEM;
+			return nullptr;
+		}
+
+		void* ptr = allocate(bytes, MIN_ALIGNMENT);
+		if (ptr == nullptr) {
+			errno = ENOMEM;
+			return nullptr;
+		}
+
+		// fresh mappings are zeroed by the kernel, slab blocks may be reused
+		if (is_in_arena(ptr))
+			std::memset(ptr, 0, bytes);
+
+		return ptr;
+	}
+
+	void* realloc(void* ptr, size_t size) {
+		void* newPtr = reallocate(ptr, size);
+		if (newPtr == nullptr && size != 0) errno = ENOMEM;
+		return newPtr;
+	}
+
+	void* reallocarray(void* ptr, size_t count, size_t size) {
+		size_t bytes;
+		if (__builtin_mul_overflow(count, size, &bytes)) {
+			errno = ENOMEM;
+			return nullptr;
+		}
+
+		return realloc(ptr, bytes);
+	}
+
+	int posix_memalign(void** result, size_t alignment, size_t size) {
+		if (!is_valid_alignment(alignment) || alignment % sizeof(void*) != 0) return EINVAL;
+
+		void* ptr = allocate(size, alignment);
+		if (ptr == nullptr) return ENOMEM;
+
+		*result = ptr;
+		return 0;
+	}
+
+	void* aligned_alloc(size_t alignment, size_t size) {
+		if (!is_valid_alignment(alignment)) {
+			errno = EINVAL;
+			return nullptr;
+		}
+
+		void* ptr = allocate(size, alignment);
+		if (ptr == nullptr) errno = ENOMEM;
+		return ptr;
+	}
+
+	void* memalign(size_t alignment, size_t size) {
+		return aligned_alloc(alignment, size);
+	}
+
+	void* valloc(size_t size) {
+		return aligned_alloc(SystemMemory::get_page_size(), size);
+	}
+
+	void* pvalloc(size_t size) {
+		size_t pageSize = SystemMemory::get_page_size();
+		return aligned_alloc(pageSize, round_up(size, pageSize));
+	}
+
+	size_t malloc_usable_size(void* ptr) {
+		return get_usable_size(ptr);
+	}
+
+}
+
+void* operator new(size_t size) { return allocate_or_throw(size, MIN_ALIGNMENT); }
+void* operator new[](size_t size) { return allocate_or_throw(size, MIN_ALIGNMENT); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocate_or_throw(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocate_or_throw(size, (size_t)alignment); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size, MIN_ALIGNMENT); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate(size, MIN_ALIGNMENT); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate(size, (size_t)alignment); }
+
+void operator delete(void* ptr) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { deallocate(ptr); }
@@ -0,0 +1,96 @@
+#include <AllocatorStats.h>
+#include <MemUtils.h>
+#include <algorithm>
+
+using namespace SimpleMemoryAllocator;
+
+AllocatorStats::AllocatorStats()
+	: collected(false)
+	, capacity(0)
+	, usedMemory(0)
+	, numAllocations(0)
+	, freeMemory(0)
+	, largestFreeBlock(0)
+	, fragmentation(0.0)
+	, peakUsedMemory(0)
+	, peakNumAllocations(0)
+	, totalAllocations(0)
+	, totalDeallocations(0)
+	, failedAllocations(0)
+	, requestedBytes(0)
+	, paddingBytes(0) {
+	std::fill(sizeHistogram, sizeHistogram + NUM_SIZE_BUCKETS, 0);
+}
+
+void AllocatorStats::record_allocation(size_t size, const void* ptr, size_t used_before, size_t used_after, size_t num_allocations) {
+	if (ptr == nullptr) {
+		++failedAllocations;
+		return;
+	}
+
+	++totalAllocations;
+	++sizeHistogram[size > 0 ? MemoryUtils::get_log2_floor(size) : 0];
+	requestedBytes += size;
+
+	// allocators which do not track the used memory per block report no growth
+	if (used_after > used_before + size)
+		paddingBytes += used_after - used_before - size;
+
+	peakUsedMemory = std::max(peakUsedMemory, used_after);
+	peakNumAllocations = std::max(peakNumAllocations, num_allocations);
+}
+
+void AllocatorStats::record_batch_allocation(size_t size, size_t requested, size_t allocated, size_t used_before, size_t used_after, size_t num_allocations) {
+	failedAllocations += requested - allocated;
+	if (allocated == 0) return;
+
+	totalAllocations += allocated;
+	sizeHistogram[size > 0 ? MemoryUtils::get_log2_floor(size) : 0] += allocated;
+	requestedBytes += size * allocated;
+
+	if (used_after > used_before + size * allocated)
+		paddingBytes += used_after - used_before - size * allocated;
+
+	peakUsedMemory = std::max(peakUsedMemory, used_after);
+	peakNumAllocations = std::max(peakNumAllocations, num_allocations);
+}
+
+void AllocatorStats::reset(size_t used_memory, size_t num_allocations) {
+	peakUsedMemory = used_memory;
+	peakNumAllocations = num_allocations;
+	totalAllocations = 0;
+	totalDeallocations = 0;
+	failedAllocations = 0;
+	requestedBytes = 0;
+	paddingBytes = 0;
+	std::fill(sizeHistogram, sizeHistogram + NUM_SIZE_BUCKETS, 0);
+}
+
+void AllocatorStats::write_json(std::ostream& stream) const {
+	stream
+		<< "{\"collected\": " << (collected ? "true" : "false")
+		<< ", \"capacity\": " << capacity
+		<< ", \"used_memory\": " << usedMemory
+		<< ", \"num_allocations\": " << numAllocations
+		<< ", \"free_memory\": " << freeMemory
+		<< ", \"largest_free_block\": " << largestFreeBlock
+		<< ", \"fragmentation\": " << fragmentation
+		<< ", \"peak_used_memory\": " << peakUsedMemory
+		<< ", \"peak_num_allocations\": " << peakNumAllocations
+		<< ", \"total_allocations\": " << totalAllocations
+		<< ", \"total_deallocations\": " << totalDeallocations
+		<< ", \"failed_allocations\": " << failedAllocations
+		<< ", \"requested_bytes\": " << requestedBytes
+		<< ", \"padding_bytes\": " << paddingBytes
+		<< ", \"size_histogram\": {";
+
+	bool first = true;
+	for (size_t i = 0; i < NUM_SIZE_BUCKETS; ++i) {
+		if (sizeHistogram[i] == 0) continue;
+
+		stream << (first ? "" : ", ") << "\"" << ((size_t)1 << i) << "\": " << sizeHistogram[i];
+		first = false;
+	}
+
+	stream << "}}";
+}
@@ -0,0 +1,246 @@
+#include <BitmapPoolAllocator.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using namespace SimpleMemoryAllocator;
+
+namespace {
+	const uint64_t FULL_WORD = ~(uint64_t)0;
+
+	// mask of count bits starting at bit, count must not reach past the word
+	inline uint64_t get_bit_mask(size_t bit, size_t count) {
+		return (count == 64 ? FULL_WORD : (((uint64_t)1 << count) - 1) << bit);
+	}
+}
+
+BitmapPoolAllocator::BitmapPoolAllocator(size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source) : BitmapPoolAllocator(nullptr, memory_size, object_size, object_alignment, memory_source) { }
+
+BitmapPoolAllocator::BitmapPoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment) : BitmapPoolAllocator(memory_ptr, memory_size, object_size, object_alignment, nullptr) { }
+
+BitmapPoolAllocator::BitmapPoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source)
+	: BaseAllocator(memory_ptr, memory_size, memory_source)
+	, m_objectAlignment(object_alignment > 0 ? object_alignment : 1) {
+
+	throw_assert(object_size > 0, "bitmap pool object size must be larger than 0");
+	throw_assert(MemoryUtils::is_valid_alignment(m_objectAlignment), "bitmap pool object alignment must be a power of two");
+
+	// every slot stays aligned when the slot size is a multiple of the alignment
+	m_objectSize = MemoryUtils::get_aligned_size(object_size, m_objectAlignment);
+
+	// the bitmap goes first, the slots right after it, each slot costs its size and a single bit
+	size_t bitmapAdjustment = MemoryUtils::get_next_address_adjustment(m_start, alignof(uint64_t));
+	size_t available = (memory_size > bitmapAdjustment ? memory_size - bitmapAdjustment : 0);
+	char* end = (char*)m_start + memory_size;
+
+	m_numSlots = available * 8 / (8 * m_objectSize + 1);
+	for (; m_numSlots > 0; --m_numSlots) {
+		m_numWords = (m_numSlots + 63) / 64;
+		m_slots = MemoryUtils::add_to_pointer(m_start, bitmapAdjustment + m_numWords * sizeof(uint64_t));
+		m_slots = MemoryUtils::add_to_pointer(m_slots, MemoryUtils::get_next_address_adjustment(m_slots, m_objectAlignment));
+
+		if ((char*)m_slots + m_numSlots * m_objectSize <= end) break;
+	}
+	throw_assert(m_numSlots > 0, "bitmap pool memory must hold at least one slot");
+
+	// requests up to the alignment all slots share can be served by any slot
+	m_slotAlignment = MemoryUtils::get_guaranteed_alignment(m_slots, m_objectSize);
+
+	m_bitmap = (uint64_t*)MemoryUtils::add_to_pointer(m_start, bitmapAdjustment);
+	for (size_t i = 0; i < m_numWords; ++i)
+		m_bitmap[i] = 0;
+
+	// the padding bits past the last slot are marked as used, so that they are never found free
+	if (m_numSlots % 64 != 0)
+		m_bitmap[m_numWords - 1] = ~get_bit_mask(0, m_numSlots % 64);
+
+	m_firstFreeWord = 0;
+}
+
+size_t BitmapPoolAllocator::find_free_word(size_t from) const noexcept {
+	size_t word = from;
+
+	// skip the full words several at a time, the exact word is then found by the scalar loop
+#if defined(__AVX2__)
+	const __m256i fullWords = _mm256_set1_epi64x(-1);
+	for (; word + 4 <= m_numWords; word += 4) {
+		__m256i words = _mm256_loadu_si256((const __m256i*)(m_bitmap + word));
+		if (!_mm256_testc_si256(words, fullWords)) break;
+	}
+#elif defined(__SSE2__)
+	const __m128i fullWords = _mm_set1_epi8(-1);
+	for (; word + 2 <= m_numWords; word += 2) {
+		__m128i words = _mm_loadu_si128((const __m128i*)(m_bitmap + word));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(words, fullWords)) != 0xFFFF) break;
+	}
+#endif
+
+	for (; word < m_numWords; ++word) {
+		if (m_bitmap[word] != FULL_WORD) return word;
+	}
+
+	return m_numWords;
+}
+
+size_t BitmapPoolAllocator::find_next_free(size_t slot) const noexcept {
+	size_t word = slot / 64;
+	if (word >= m_numWords) return m_numSlots;
+
+	uint64_t freeBits = ~m_bitmap[word] & (FULL_WORD << (slot % 64));
+	if (freeBits == 0) {
+		word = find_free_word(word + 1);
+		if (word == m_numWords) return m_numSlots;
+
+		freeBits = ~m_bitmap[word];
+	}
+
+	return word * 64 + MemoryUtils::get_trailing_zeros(freeBits);
+}
+
+size_t BitmapPoolAllocator::find_next_used(size_t slot) const noexcept {
+	size_t word = slot / 64;
+	if (word >= m_numWords) return m_numSlots;
+
+	uint64_t usedBits = m_bitmap[word] & (FULL_WORD << (slot % 64));
+	while (usedBits == 0) {
+		if (++word == m_numWords) return m_numSlots;
+		usedBits = m_bitmap[word];
+	}
+
+	// the padding bits are set, so the end of the last free run may lie past the last slot
+	size_t used = word * 64 + MemoryUtils::get_trailing_zeros(usedBits);
+	return (used < m_numSlots ? used : m_numSlots);
+}
+
+bool BitmapPoolAllocator::test_range(size_t first, size_t count, bool used) const noexcept {
+	while (count > 0) {
+		size_t bit = first % 64;
+		size_t bits = (64 - bit < count ? 64 - bit : count);
+		uint64_t mask = get_bit_mask(bit, bits);
+
+		if ((m_bitmap[first / 64] & mask) != (used ? mask : 0)) return false;
+
+		first += bits;
+		count -= bits;
+	}
+
+	return true;
+}
+
+void BitmapPoolAllocator::set_range(size_t first, size_t count, bool used) noexcept {
+	while (count > 0) {
+		size_t bit = first % 64;
+		size_t bits = (64 - bit < count ? 64 - bit : count);
+		uint64_t mask = get_bit_mask(bit, bits);
+
+		if (used)
+			m_bitmap[first / 64] |= mask;
+		else
+			m_bitmap[first / 64] &= ~mask;
+
+		first += bits;
+		count -= bits;
+	}
+}
+
+size_t BitmapPoolAllocator::get_slot_index(const void* ptr) const {
+	throw_assert(ptr >= m_slots && ptr < MemoryUtils::add_to_pointer(m_slots, m_numSlots * m_objectSize), "pointer must point to a slot of the bitmap pool");
+
+	size_t offset = (const char*)ptr - (const char*)m_slots;
+	throw_assert(offset % m_objectSize == 0, "pointer must point to the beginning of a slot");
+
+	return offset / m_objectSize;
+}
+
+void* BitmapPoolAllocator::__allocate(size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+
+	// a request that does not fit in a slot would overwrite the neighbouring one
+	if (size > m_objectSize || alignment > m_slotAlignment) return nullptr;
+
+	size_t word = find_free_word(m_firstFreeWord);
+	m_firstFreeWord = word;
+	if (word == m_numWords) return nullptr;
+
+	// the lowest free slot of the lowest word with one
+	uint8_t bit = MemoryUtils::get_trailing_zeros(~m_bitmap[word]);
+	m_bitmap[word] |= (uint64_t)1 << bit;
+
+	m_used_memory += m_objectSize;
+	++m_num_allocations;
+
+	return MemoryUtils::add_to_pointer(m_slots, (word * 64 + bit) * m_objectSize);
+}
+
+void BitmapPoolAllocator::__deallocate(void* ptr) {
+	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+	size_t slot = get_slot_index(ptr);
+	size_t word = slot / 64;
+	uint64_t mask = (uint64_t)1 << (slot % 64);
+	throw_assert((m_bitmap[word] & mask) != 0, "deallocated slot is not allocated, it may have been deallocated twice");
+
+	m_bitmap[word] &= ~mask;
+	if (word < m_firstFreeWord)
+		m_firstFreeWord = word;
+
+	m_used_memory -= m_objectSize;
+	--m_num_allocations;
+}
+
+void* BitmapPoolAllocator::allocate_contiguous(size_t count) {
+	throw_assert(count > 0, "number of allocated slots must be larger than 0");
+
+	// walk the free runs from the lowest address until one is long enough
+	size_t first = find_next_free(m_firstFreeWord * 64);
+	while (first < m_numSlots && m_numSlots - first >= count) {
+		size_t end = find_next_used(first);
+
+		if (end - first >= count) {
+			set_range(first, count, true);
+			m_used_memory += count * m_objectSize;
+			m_num_allocations += count;
+
+			return MemoryUtils::add_to_pointer(m_slots, first * m_objectSize);
+		}
+
+		first = find_next_free(end);
+	}
+
+	return nullptr;
+}
+
+void BitmapPoolAllocator::deallocate_contiguous(void* ptr, size_t count) {
+	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+	size_t first = get_slot_index(ptr);
+	throw_assert(count > 0 && first + count <= m_numSlots, "deallocated slots must lie within the bitmap pool");
+	throw_assert(test_range(first, count, true), "deallocated slots are not all allocated, some may have been deallocated twice");
+
+	set_range(first, count, false);
+	if (first / 64 < m_firstFreeWord)
+		m_firstFreeWord = first / 64;
+
+	m_used_memory -= count * m_objectSize;
+	m_num_allocations -= count;
+}
+
+bool BitmapPoolAllocator::is_live(const void* ptr) const {
+	size_t slot = get_slot_index(ptr);
+	return (m_bitmap[slot / 64] & ((uint64_t)1 << (slot % 64))) != 0;
+}
+
+void BitmapPoolAllocator::fill_stats(AllocatorStats& stats) const {
+	// every live slot is a single allocation
+	size_t freeSlots = m_numSlots - m_num_allocations;
+
+	size_t longestRun = 0;
+	for (size_t first = find_next_free(0); first < m_numSlots; ) {
+		size_t end = find_next_used(first);
+		longestRun = (end - first > longestRun ? end - first : longestRun);
+		first = find_next_free(end);
+	}
+
+	stats.set_free_space(freeSlots * m_objectSize, longestRun * m_objectSize);
+}
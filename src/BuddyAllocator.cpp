@@ -0,0 +1,216 @@
+#include <BuddyAllocator.h>
+
+using namespace SimpleMemoryAllocator;
+
+/**
+* A free block, the list links are stored in the block itself.
+*/
+struct BuddyAllocator::FreeBlock {
+	FreeBlock* next;
+	FreeBlock* previous;
+};
+
+namespace {
+	const size_t MAX_BASE_ALIGNMENT = 4096;     // blocks of a page or larger are always page aligned
+
+	inline size_t get_base_alignment(uint8_t max_order) {
+		return ((size_t)1 << max_order) < MAX_BASE_ALIGNMENT ? ((size_t)1 << max_order) : MAX_BASE_ALIGNMENT;
+	}
+
+	inline uint8_t get_log2_ceil(size_t value) {
+		return (value <= 1 ? 0 : MemoryUtils::get_log2_floor(value - 1) + 1);
+	}
+
+	inline bool test_bit(const uint64_t* bits, size_t index) {
+		return (bits[index / 64] >> (index % 64)) & 1;
+	}
+
+	inline void set_bit(uint64_t* bits, size_t index) {
+		bits[index / 64] |= (uint64_t)1 << (index % 64);
+	}
+
+	inline void clear_bit(uint64_t* bits, size_t index) {
+		bits[index / 64] &= ~((uint64_t)1 << (index % 64));
+	}
+
+	inline void toggle_bit(uint64_t* bits, size_t index) {
+		bits[index / 64] ^= (uint64_t)1 << (index % 64);
+	}
+}
+
+BuddyAllocator::BuddyAllocator(size_t memory_size, uint8_t min_order, uint8_t max_order, MemorySource* memory_source) : BuddyAllocator(nullptr, memory_size, min_order, max_order, memory_source) { }
+
+BuddyAllocator::BuddyAllocator(void* memory_ptr, size_t memory_size, uint8_t min_order, uint8_t max_order) : BuddyAllocator(memory_ptr, memory_size, min_order, max_order, nullptr) { }
+
+BuddyAllocator::BuddyAllocator(void* memory_ptr, size_t memory_size, uint8_t min_order, uint8_t max_order, MemorySource* memory_source)
+	// when allocating the memory ourselves, add enough space to align the first block
+	: BaseAllocator(memory_ptr, memory_ptr != nullptr ? memory_size : memory_size + get_base_alignment(max_order) - 1, memory_source)
+	, m_minOrder(min_order)
+	, m_maxOrder(max_order) {
+
+	throw_assert(min_order >= 4 && (size_t)1 << min_order >= sizeof(FreeBlock), "buddy allocator minimum block must be able to hold the free list links");
+	throw_assert(max_order >= min_order && max_order - min_order < MAX_LEVELS && max_order < 64, "buddy allocator orders are out of range");
+
+	size_t baseAlignment = get_base_alignment(max_order);
+	uintptr_t base = ((uintptr_t)m_start + baseAlignment - 1) & ~(baseAlignment - 1);
+	m_base = (void*)base;
+
+	size_t adjustment = base - (uintptr_t)m_start;
+	m_numRoots = (m_size > adjustment ? (m_size - adjustment) >> max_order : 0);
+	throw_assert(m_numRoots > 0, "buddy allocator memory must hold at least one block of the maximum order");
+
+	m_numLevels = max_order - min_order + 1;
+	m_innerNodesPerRoot = ((size_t)1 << (m_numLevels - 1)) - 1;
+
+	// both bitmaps share a single allocation, an allocator without inner nodes still gets one word
+	size_t bitmapWords = (m_numRoots * m_innerNodesPerRoot + 63) / 64 + 1;
+	m_splitBits = (uint64_t*)::operator new(2 * bitmapWords * sizeof(uint64_t));
+	m_freePairBits = m_splitBits + bitmapWords;
+	for (size_t i = 0; i < 2 * bitmapWords; ++i)
+		m_splitBits[i] = 0;
+
+	for (uint8_t level = 0; level < MAX_LEVELS; ++level)
+		m_freeLists[level] = nullptr;
+
+	// push the roots in reverse, so that the lowest addresses are handed out first
+	for (size_t root = m_numRoots; root > 0; --root)
+		push_free_block(MemoryUtils::add_to_pointer(m_base, (root - 1) << max_order), root - 1, 0, 0);
+}
+
+BuddyAllocator::~BuddyAllocator() {
+	::operator delete(m_splitBits);
+	m_splitBits = nullptr;
+	m_freePairBits = nullptr;
+}
+
+size_t BuddyAllocator::get_node(size_t root, uint8_t level, size_t index) const {
+	// inner nodes of each root tree are numbered like a binary heap
+	return root * m_innerNodesPerRoot + ((size_t)1 << level) - 1 + index;
+}
+
+void BuddyAllocator::push_free_block(void* block, size_t root, uint8_t level, size_t index) {
+	FreeBlock* freeBlock = (FreeBlock*)block;
+	FreeBlock*& head = m_freeLists[level];
+
+	freeBlock->previous = nullptr;
+	freeBlock->next = head;
+	if (head != nullptr)
+		head->previous = freeBlock;
+	head = freeBlock;
+
+	if (level > 0)
+		toggle_bit(m_freePairBits, get_node(root, level - 1, index / 2));
+}
+
+void BuddyAllocator::remove_free_block(FreeBlock* block, size_t root, uint8_t level, size_t index) {
+	if (block->previous != nullptr)
+		block->previous->next = block->next;
+	else
+		m_freeLists[level] = block->next;
+
+	if (block->next != nullptr)
+		block->next->previous = block->previous;
+
+	if (level > 0)
+		toggle_bit(m_freePairBits, get_node(root, level - 1, index / 2));
+}
+
+void* BuddyAllocator::__allocate(size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+
+	// larger blocks are aligned to their size, so a large alignment only requires a large enough block
+	uint8_t order = get_log2_ceil(size);
+	if (alignment > 1 && get_log2_ceil(alignment) > order) order = get_log2_ceil(alignment);
+	if (order < m_minOrder) order = m_minOrder;
+
+	// return null pointer if the request is larger than the largest block, or if the blocks are aligned relative
+	// to a base which is not aligned enough itself
+	if (order > m_maxOrder || ((uintptr_t)m_base & (alignment - 1)) != 0) return nullptr;
+
+	// find the smallest free block large enough
+	uint8_t targetLevel = m_maxOrder - order;
+	int level = targetLevel;
+	while (level >= 0 && m_freeLists[level] == nullptr)
+		--level;
+
+	// return null pointer if there is no free block large enough
+	if (level < 0) return nullptr;
+
+	FreeBlock* block = m_freeLists[level];
+	size_t offset = (char*)block - (char*)m_base;
+	size_t root = offset >> m_maxOrder;
+	size_t rootOffset = offset & (((size_t)1 << m_maxOrder) - 1);
+	remove_free_block(block, root, level, rootOffset >> (m_maxOrder - level));
+
+	// split the block until it has the requested size, the left half is kept and the right one is freed
+	for (; level < targetLevel; ++level) {
+		set_bit(m_splitBits, get_node(root, level, rootOffset >> (m_maxOrder - level)));
+
+		size_t rightOffset = rootOffset + ((size_t)1 << (m_maxOrder - level - 1));
+		push_free_block(MemoryUtils::add_to_pointer(m_base, (root << m_maxOrder) + rightOffset), root, level + 1, rightOffset >> (m_maxOrder - level - 1));
+	}
+
+	m_used_memory += (size_t)1 << order;
+	++m_num_allocations;
+
+	return block;
+}
+
+void BuddyAllocator::__deallocate(void* ptr) {
+	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+	size_t offset = (char*)ptr - (char*)m_base;
+	size_t root = offset >> m_maxOrder;
+	size_t rootOffset = offset & (((size_t)1 << m_maxOrder) - 1);
+	throw_assert(ptr >= m_base && root < m_numRoots, "deallocated pointer does not belong to the allocator");
+
+	// the allocated block is the first node on the path from the root which is not split
+	uint8_t level = 0;
+	while (level < m_numLevels - 1 && test_bit(m_splitBits, get_node(root, level, rootOffset >> (m_maxOrder - level))))
+		++level;
+
+	throw_assert((rootOffset & (((size_t)1 << (m_maxOrder - level)) - 1)) == 0, "deallocated pointer is not the start of a block");
+
+	m_used_memory -= (size_t)1 << (m_maxOrder - level);
+	--m_num_allocations;
+
+	// merge with the buddy as long as it is free, the free pair bit of the parent is set exactly when the buddy is free
+	for (; level > 0; --level) {
+		size_t index = rootOffset >> (m_maxOrder - level);
+		size_t parent = get_node(root, level - 1, index / 2);
+		if (!test_bit(m_freePairBits, parent)) break;
+
+		size_t buddyOffset = rootOffset ^ ((size_t)1 << (m_maxOrder - level));
+		FreeBlock* buddy = (FreeBlock*)MemoryUtils::add_to_pointer(m_base, (root << m_maxOrder) + buddyOffset);
+		remove_free_block(buddy, root, level, index ^ 1);
+		clear_bit(m_splitBits, parent);
+
+		rootOffset &= ~((size_t)1 << (m_maxOrder - level));
+	}
+
+	push_free_block(MemoryUtils::add_to_pointer(m_base, (root << m_maxOrder) + rootOffset), root, level, rootOffset >> (m_maxOrder - level));
+}
+
+void BuddyAllocator::fill_stats(AllocatorStats& stats) const {
+	size_t freeMemory = 0;
+	size_t largestFreeBlock = 0;
+
+	for (uint8_t level = 0; level < m_numLevels; ++level) {
+		size_t blockSize = (size_t)1 << (m_maxOrder - level);
+
+		for (FreeBlock* block = m_freeLists[level]; block != nullptr; block = block->next) {
+			freeMemory += blockSize;
+			largestFreeBlock = (blockSize > largestFreeBlock ? blockSize : largestFreeBlock);
+		}
+	}
+
+	size_t freeRoots = 0;
+	for (FreeBlock* block = m_freeLists[0]; block != nullptr; block = block->next)
+		++freeRoots;
+
+	stats.capacity = m_numRoots << m_maxOrder;
+	stats.set_free_space(freeMemory, largestFreeBlock);
+
+	// no block is larger than the maximum order, so only the free memory split into smaller blocks is fragmented
+	stats.fragmentation = (freeMemory > 0 ? 1.0 - (double)(freeRoots << m_maxOrder) / freeMemory : 0.0);
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include <ConcurrentLinearAllocator.h>
+
+using namespace SimpleMemoryAllocator;
+
+ConcurrentLinearAllocator::ConcurrentLinearAllocator(size_t memory_size, MemorySource* memory_source) : ConcurrentLinearAllocator(nullptr, memory_size, memory_source) { }
+
+ConcurrentLinearAllocator::ConcurrentLinearAllocator(void* memory_ptr, size_t memory_size) : ConcurrentLinearAllocator(memory_ptr, memory_size, nullptr) { }
+
+ConcurrentLinearAllocator::ConcurrentLinearAllocator(void* memory_ptr, size_t memory_size, MemorySource* memory_source)
+	: BaseAllocator(memory_ptr, memory_size, memory_source)
+	, m_offset(0)
+	, m_allocated(0)
+	, m_generation(0) {
+
+	// every offset stays a multiple of BASE_ALIGNMENT, so the base has to be aligned to it as well
+	size_t adjustment = MemoryUtils::get_next_address_adjustment(m_start, BASE_ALIGNMENT);
+	m_base = MemoryUtils::add_to_pointer(m_start, adjustment);
+	m_capacity = (memory_size > adjustment ? memory_size - adjustment : 0);
+
+	// a relocated block stays where it was until clear()
+	m_deallocates_blocks = false;
+
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+	// the shared BaseAllocator statistics cannot be updated from several threads at once
+	m_record_stats = false;
+#endif
+}
+
+ConcurrentLinearAllocator::~ConcurrentLinearAllocator() {
+	// hand the counters over to BaseAllocator, so that it can report leaks
+	m_num_allocations = get_num_allocations();
+	m_used_memory = (m_num_allocations > 0 ? get_used_memory() : 0);
+}
+
+void* ConcurrentLinearAllocator::bump(size_t size, size_t alignment) {
+	// sizes are rounded up to BASE_ALIGNMENT, so the next offset is always aligned to it
+	size_t alignedSize = MemoryUtils::get_aligned_size(size, BASE_ALIGNMENT);
+	size_t offset = m_offset.load(std::memory_order_relaxed);
+
+	if (alignment <= BASE_ALIGNMENT) {
+		// don't bump a full allocator, so that a large failed request does not make the smaller ones fail too
+		if (offset > m_capacity || m_capacity - offset < alignedSize) return nullptr;
+
+		offset = m_offset.fetch_add(alignedSize, std::memory_order_relaxed);
+		if (offset > m_capacity || m_capacity - offset < alignedSize) return nullptr;
+
+		return MemoryUtils::add_to_pointer(m_base, offset);
+	}
+
+	// a larger alignment depends on the current offset, so it has to be bumped by a compare-and-swap
+	size_t alignedOffset;
+	do {
+		if (offset > m_capacity) return nullptr;
+
+		alignedOffset = offset + MemoryUtils::get_next_address_adjustment(MemoryUtils::add_to_pointer(m_base, offset), alignment);
+		if (alignedOffset > m_capacity || m_capacity - alignedOffset < alignedSize) return nullptr;
+	} while (!m_offset.compare_exchange_weak(offset, alignedOffset + alignedSize, std::memory_order_relaxed, std::memory_order_relaxed));
+
+	return MemoryUtils::add_to_pointer(m_base, alignedOffset);
+}
+
+void* ConcurrentLinearAllocator::__allocate(size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+
+	void* ptr = bump(size, alignment);
+	if (ptr != nullptr)
+		m_allocated.fetch_add(1, std::memory_order_relaxed);
+
+	return ptr;
+}
+
+void ConcurrentLinearAllocator::__deallocate(void* ptr) {
+	throw_assert(false, "method deallocate() is not usable in a linear allocator, use method clear() instead");
+}
+
+void ConcurrentLinearAllocator::clear() {
+	m_offset.store(0, std::memory_order_relaxed);
+	m_allocated.store(0, std::memory_order_relaxed);
+	m_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ConcurrentLinearAllocator::fill_stats(AllocatorStats& stats) const {
+	stats.capacity = m_capacity;
+	stats.usedMemory = get_used_memory();
+	stats.numAllocations = get_num_allocations();
+
+	size_t freeMemory = (stats.capacity > stats.usedMemory ? stats.capacity - stats.usedMemory : 0);
+	stats.set_free_space(freeMemory, freeMemory);
+}
+
+ConcurrentLinearAllocator::ThreadBuffer::ThreadBuffer(ConcurrentLinearAllocator& allocator, size_t block_size)
+	: m_allocator(allocator)
+	, m_blockSize(MemoryUtils::get_aligned_size(block_size, BASE_ALIGNMENT))
+	, m_firstFree(nullptr)
+	, m_end(nullptr)
+	, m_generation(allocator.m_generation.load(std::memory_order_relaxed))
+	, m_numAllocations(0) {
+
+	throw_assert(block_size > 0, "thread buffer block size must be larger than 0");
+}
+
+ConcurrentLinearAllocator::ThreadBuffer::~ThreadBuffer() {
+	flush_counter();
+}
+
+void ConcurrentLinearAllocator::ThreadBuffer::flush_counter() {
+	// the allocations of a cleared generation are gone already
+	if (m_numAllocations > 0 && m_generation == m_allocator.m_generation.load(std::memory_order_relaxed))
+		m_allocator.m_allocated.fetch_add(m_numAllocations, std::memory_order_relaxed);
+
+	m_numAllocations = 0;
+}
+
+bool ConcurrentLinearAllocator::ThreadBuffer::refill() {
+	flush_counter();
+
+	void* block = m_allocator.bump(m_blockSize, BASE_ALIGNMENT);
+	if (block == nullptr) return false;
+
+	m_firstFree = block;
+	m_end = MemoryUtils::add_to_pointer(block, m_blockSize);
+	m_generation = m_allocator.m_generation.load(std::memory_order_relaxed);
+
+	return true;
+}
+
+void* ConcurrentLinearAllocator::ThreadBuffer::allocate_raw(size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+
+	// the sub-block is gone once the allocator was cleared
+	if (m_generation != m_allocator.m_generation.load(std::memory_order_relaxed)) {
+		m_firstFree = nullptr;
+		m_end = nullptr;
+		m_numAllocations = 0;
+	}
+
+	// large requests would waste most of a sub-block
+	if (size + alignment > m_blockSize / 4)
+		return m_allocator.allocate_raw(size, alignment);
+
+	size_t adjustment = MemoryUtils::get_next_address_adjustment(m_firstFree, alignment);
+
+	if ((size_t)((char*)m_end - (char*)m_firstFree) < adjustment + size) {
+		// the rest of the shared memory may still hold this request even when a whole sub-block does not fit
+		if (!refill()) return m_allocator.allocate_raw(size, alignment);
+
+		adjustment = MemoryUtils::get_next_address_adjustment(m_firstFree, alignment);
+	}
+
+	void* alignedAddress = MemoryUtils::add_to_pointer(m_firstFree, adjustment);
+	m_firstFree = MemoryUtils::add_to_pointer(alignedAddress, size);
+	++m_numAllocations;
+
+	return alignedAddress;
+}
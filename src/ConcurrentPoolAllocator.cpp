@@ -0,0 +1,141 @@
+#include <ConcurrentPoolAllocator.h>
+
+using namespace SimpleMemoryAllocator;
+
+namespace {
+	// free slots store the index of the next free slot + 1 in their first bytes, 0 terminates the list
+	inline std::atomic<uint32_t>* next_link(void* slot) {
+		return reinterpret_cast<std::atomic<uint32_t>*>(slot);
+	}
+
+	inline uint64_t make_head(uint64_t tag, uint32_t link) {
+		return (tag << 32) | link;
+	}
+}
+
+ConcurrentPoolAllocator::ConcurrentPoolAllocator(size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source) : ConcurrentPoolAllocator(nullptr, memory_size, object_size, object_alignment, memory_source) { }
+
+ConcurrentPoolAllocator::ConcurrentPoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment) : ConcurrentPoolAllocator(memory_ptr, memory_size, object_size, object_alignment, nullptr) { }
+
+ConcurrentPoolAllocator::ConcurrentPoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source)
+	: BaseAllocator(memory_ptr, memory_size, memory_source)
+	, m_head(0)
+	, m_allocated(0)
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+	, m_peakAllocated(0)
+	, m_totalAllocations(0)
+	, m_totalDeallocations(0)
+	, m_failedAllocations(0)
+#endif
+	, m_objectSize(MemoryUtils::get_aligned_size(object_size, object_alignment))
+	, m_objectAlignment(object_alignment) {
+
+	throw_assert(object_size >= sizeof(uint32_t), "concurrent pool element must be able to hold a free list index");
+	throw_assert(MemoryUtils::is_valid_alignment(object_alignment), "concurrent pool element alignment must be a power of two");
+
+	size_t adjustment = MemoryUtils::get_next_address_adjustment(m_start, object_alignment);
+	m_slots = MemoryUtils::add_to_pointer(m_start, adjustment);
+
+	// requests up to the alignment all slots share can be served by any slot
+	m_slotAlignment = MemoryUtils::get_guaranteed_alignment(m_slots, m_objectSize);
+
+	size_t numObjects = (memory_size > adjustment ? (memory_size - adjustment) / m_objectSize : 0);
+	throw_assert(numObjects > 0 && numObjects < UINT32_MAX, "concurrent pool must hold between 1 and 2^32 - 2 elements");
+	m_numSlots = (uint32_t)numObjects;
+
+	// initialize the free slot list, slot n initially points to slot n+1 and the last one terminates the list
+	for (uint32_t i = 0; i < m_numSlots - 1; ++i)
+		next_link(get_slot(i))->store(i + 2, std::memory_order_relaxed);
+	next_link(get_slot(m_numSlots - 1))->store(0, std::memory_order_relaxed);
+
+	m_head.store(make_head(0, 1), std::memory_order_release);
+
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+	// the shared BaseAllocator statistics cannot be updated from several threads at once
+	m_record_stats = false;
+#endif
+}
+
+ConcurrentPoolAllocator::~ConcurrentPoolAllocator() {
+	// hand the counters over to BaseAllocator, so that it can report leaks
+	m_num_allocations = get_num_allocations();
+	m_used_memory = get_used_memory();
+}
+
+void* ConcurrentPoolAllocator::__allocate(size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+
+	uint64_t head = m_head.load(std::memory_order_acquire);
+	void* slot;
+
+	for (;;) {
+		uint32_t link = (uint32_t)head;
+
+		// return null pointer if there are no more slots left, or if the request does not fit in a slot
+		// and would overwrite the neighbouring one, or asks for a larger alignment than the slots have
+		if (link == 0 || size > m_objectSize || alignment > m_slotAlignment) {
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+			m_failedAllocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+			return nullptr;
+		}
+
+		slot = get_slot(link - 1);
+
+		// another thread may pop this slot and overwrite the link in the meantime, the read value is garbage
+		// then, but the version tag in the head changed as well, so the exchange below fails and we retry
+		uint32_t next = next_link(slot)->load(std::memory_order_relaxed);
+
+		if (m_head.compare_exchange_weak(head, make_head((head >> 32) + 1, next), std::memory_order_acquire, std::memory_order_acquire))
+			break;
+	}
+
+	size_t allocated = m_allocated.fetch_add(1, std::memory_order_relaxed) + 1;
+
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+	m_totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	size_t peak = m_peakAllocated.load(std::memory_order_relaxed);
+	while (allocated > peak && !m_peakAllocated.compare_exchange_weak(peak, allocated, std::memory_order_relaxed));
+#else
+	(void)allocated;
+#endif
+
+	return slot;
+}
+
+void ConcurrentPoolAllocator::__deallocate(void* ptr) {
+	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+	uint32_t link = (uint32_t)(((char*)ptr - (char*)m_slots) / m_objectSize) + 1;
+	uint64_t head = m_head.load(std::memory_order_relaxed);
+
+	do {
+		next_link(ptr)->store((uint32_t)head, std::memory_order_relaxed);
+	} while (!m_head.compare_exchange_weak(head, make_head((head >> 32) + 1, link), std::memory_order_release, std::memory_order_relaxed));
+
+	m_allocated.fetch_sub(1, std::memory_order_relaxed);
+
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+	m_totalDeallocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+void ConcurrentPoolAllocator::fill_stats(AllocatorStats& stats) const {
+	size_t allocated = m_allocated.load(std::memory_order_relaxed);
+
+	stats.capacity = (size_t)m_numSlots * m_objectSize;
+	stats.usedMemory = allocated * m_objectSize;
+	stats.numAllocations = allocated;
+	stats.freeMemory = stats.capacity - stats.usedMemory;
+	stats.largestFreeBlock = (allocated < m_numSlots ? m_objectSize : 0);
+	stats.fragmentation = 0.0;     // any free slot serves any request
+
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+	stats.peakNumAllocations = m_peakAllocated.load(std::memory_order_relaxed);
+	stats.peakUsedMemory = stats.peakNumAllocations * m_objectSize;
+	stats.totalAllocations = m_totalAllocations.load(std::memory_order_relaxed);
+	stats.totalDeallocations = m_totalDeallocations.load(std::memory_order_relaxed);
+	stats.failedAllocations = m_failedAllocations.load(std::memory_order_relaxed);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include <FrameAllocator.h>
+#include <new>
+
+using namespace SimpleMemoryAllocator;
+
+/**
+* A single frame buffer, a linear allocator working on its slice of the allocator memory.
+*/
+struct FrameAllocator::Frame {
+	LinearAllocator buffer;     /// the allocator of the frame data
+
+	Frame(void* memory_ptr, size_t memory_size) : buffer(memory_ptr, memory_size) { }
+};
+
+FrameAllocator::FrameAllocator(size_t frame_size, size_t num_frames, MemorySource* memory_source) : FrameAllocator(nullptr, frame_size, num_frames, memory_source) { }
+
+FrameAllocator::FrameAllocator(void* memory_ptr, size_t frame_size, size_t num_frames) : FrameAllocator(memory_ptr, frame_size, num_frames, nullptr) { }
+
+FrameAllocator::FrameAllocator(void* memory_ptr, size_t frame_size, size_t num_frames, MemorySource* memory_source)
+	: BaseAllocator(memory_ptr, frame_size * num_frames, memory_source)
+	, m_numFrames(num_frames)
+	, m_frameSize(frame_size)
+	, m_currentFrame(0)
+	, m_frameNumber(0)
+	, m_lastHighWaterMark(0)
+	, m_peakHighWaterMark(0) {
+
+	throw_assert(num_frames > 0, "frame allocator must have at least one frame buffer");
+	throw_assert(frame_size > 0, "frame buffer size must be larger than 0");
+
+	m_frames = static_cast<Frame*>(::operator new(num_frames * sizeof(Frame)));
+	for (size_t i = 0; i < num_frames; ++i)
+		new (&m_frames[i]) Frame(MemoryUtils::add_to_pointer(m_start, i * frame_size), frame_size);
+
+	// a relocated block stays where it was until its frame buffer is cleared
+	m_deallocates_blocks = false;
+}
+
+FrameAllocator::~FrameAllocator() {
+	// the frame data is released by design, clearing the buffers avoids their leak warnings
+	for (size_t i = 0; i < m_numFrames; ++i) {
+		m_frames[i].buffer.clear();
+		m_frames[i].~Frame();
+	}
+
+	::operator delete(m_frames);
+	m_frames = nullptr;
+
+	m_used_memory = 0;
+	m_num_allocations = 0;
+}
+
+void* FrameAllocator::__allocate(size_t size, size_t alignment) {
+	LinearAllocator& buffer = m_frames[m_currentFrame].buffer;
+	size_t usedBefore = buffer.get_used_memory();
+
+	void* ptr = buffer.allocate_raw(size, alignment);
+	if (ptr == nullptr) return nullptr;
+
+	m_used_memory += buffer.get_used_memory() - usedBefore;
+	++m_num_allocations;
+
+	return ptr;
+}
+
+void FrameAllocator::__deallocate(void* ptr) {
+	throw_assert(false, "method deallocate() is not usable in a frame allocator, the memory is released by begin_frame()");
+}
+
+bool FrameAllocator::__try_expand_in_place(void* ptr, size_t old_size, size_t new_size) {
+	LinearAllocator& buffer = m_frames[m_currentFrame].buffer;
+	size_t usedBefore = buffer.get_used_memory();
+
+	if (!buffer.try_expand_in_place(ptr, old_size, new_size)) return false;
+
+	m_used_memory = m_used_memory - usedBefore + buffer.get_used_memory();
+	return true;
+}
+
+void FrameAllocator::begin_frame() {
+	size_t frameUsed = m_frames[m_currentFrame].buffer.get_used_memory();
+	m_lastHighWaterMark = frameUsed;
+	m_peakHighWaterMark = (frameUsed > m_peakHighWaterMark ? frameUsed : m_peakHighWaterMark);
+
+	m_currentFrame = (m_currentFrame + 1 < m_numFrames ? m_currentFrame + 1 : 0);
+	++m_frameNumber;
+
+	// the oldest frame gives way to the new one
+	LinearAllocator& buffer = m_frames[m_currentFrame].buffer;
+	m_used_memory -= buffer.get_used_memory();
+	m_num_allocations -= buffer.get_num_allocations();
+	buffer.clear();
+}
+
+size_t FrameAllocator::get_frame_used_memory() const noexcept {
+	return m_frames[m_currentFrame].buffer.get_used_memory();
+}
+
+void FrameAllocator::reset_high_water_marks() noexcept {
+	m_lastHighWaterMark = 0;
+	m_peakHighWaterMark = 0;
+}
+
+void FrameAllocator::fill_stats(AllocatorStats& stats) const {
+	// only the current frame buffer can be allocated from
+	size_t freeMemory = m_frameSize - get_frame_used_memory();
+	stats.set_free_space(freeMemory, freeMemory);
+}
@@ -0,0 +1,253 @@
+#include <FreeListAllocator.h>
+
+using namespace SimpleMemoryAllocator;
+
+/**
+* Header stored at the beginning of every block, free or used. The user data follows right after it.
+*/
+struct FreeListAllocator::BlockHeader {
+	size_t previousSize;    /// size of the physically previous block in bytes, 0 for the first block
+	size_t size;            /// size of this block in bytes including the header, the lowest bit is set for used blocks
+};
+
+/**
+* A free block, the list links are stored in the place of the user data.
+*/
+struct FreeListAllocator::FreeBlock : public FreeListAllocator::BlockHeader {
+	FreeBlock* next;
+	FreeBlock* previous;
+};
+
+namespace {
+	const size_t BLOCK_GRANULARITY = 16;                    // block sizes and addresses are multiples of this
+	const size_t HEADER_SIZE = 2 * sizeof(size_t);          // size of BlockHeader, keeps the user data aligned to 16
+	const size_t MIN_BLOCK_SIZE = HEADER_SIZE + 2 * sizeof(void*);
+	const size_t USED_FLAG = 1;
+
+	inline size_t round_up(size_t value, size_t multiple) {
+		return (value + multiple - 1) & ~(multiple - 1);
+	}
+}
+
+FreeListAllocator::FreeListAllocator(size_t memory_size, FitPolicy policy, MemorySource* memory_source) : FreeListAllocator(nullptr, memory_size, policy, memory_source) { }
+
+FreeListAllocator::FreeListAllocator(void* memory_ptr, size_t memory_size, FitPolicy policy) : FreeListAllocator(memory_ptr, memory_size, policy, nullptr) { }
+
+FreeListAllocator::FreeListAllocator(void* memory_ptr, size_t memory_size, FitPolicy policy, MemorySource* memory_source) : BaseAllocator(memory_ptr, memory_size, memory_source), m_policy(policy) {
+	for (size_t i = 0; i < NUM_SEGREGATED_LISTS; ++i)
+		m_freeLists[i] = nullptr;
+
+	size_t adjustment = MemoryUtils::get_next_address_adjustment(m_start, BLOCK_GRANULARITY);
+	size_t usableSize = (memory_size > adjustment ? (memory_size - adjustment) & ~(BLOCK_GRANULARITY - 1) : 0);
+
+	throw_assert(usableSize >= MIN_BLOCK_SIZE + HEADER_SIZE, "free list allocator memory is too small");
+
+	// the whole memory is a single free block, followed by a used zero-sized sentinel block which
+	// stops the coalescing at the end of the memory
+	FreeBlock* block = (FreeBlock*)MemoryUtils::add_to_pointer(m_start, adjustment);
+	size_t blockSize = usableSize - HEADER_SIZE;
+	block->previousSize = 0;
+	block->size = blockSize;
+
+	BlockHeader* sentinel = (BlockHeader*)MemoryUtils::add_to_pointer(block, blockSize);
+	sentinel->previousSize = blockSize;
+	sentinel->size = USED_FLAG;
+
+	insert_free_block(block, blockSize);
+}
+
+FreeListAllocator::~FreeListAllocator() {
+	for (size_t i = 0; i < NUM_SEGREGATED_LISTS; ++i)
+		m_freeLists[i] = nullptr;
+}
+
+size_t FreeListAllocator::get_list_index(size_t block_size) const {
+	if (m_policy != SEGREGATED_FIT) return 0;
+
+	// bucket i holds blocks of [2^(i+5), 2^(i+6)) bytes, the last one holds everything larger
+	size_t index = MemoryUtils::get_log2_floor(block_size) - 5;
+	return (index < NUM_SEGREGATED_LISTS ? index : NUM_SEGREGATED_LISTS - 1);
+}
+
+void FreeListAllocator::insert_free_block(FreeBlock* block, size_t block_size) {
+	FreeBlock*& head = m_freeLists[get_list_index(block_size)];
+
+	block->previous = nullptr;
+	block->next = head;
+	if (head != nullptr)
+		head->previous = block;
+	head = block;
+}
+
+void FreeListAllocator::remove_free_block(FreeBlock* block, size_t block_size) {
+	if (block->previous != nullptr)
+		block->previous->next = block->next;
+	else
+		m_freeLists[get_list_index(block_size)] = block->next;
+
+	if (block->next != nullptr)
+		block->next->previous = block->previous;
+}
+
+FreeListAllocator::FreeBlock* FreeListAllocator::find_free_block(size_t size, size_t alignment, size_t& gap) {
+	FreeBlock* bestBlock = nullptr;
+	size_t bestSize = 0;
+	size_t bestGap = 0;
+
+	for (size_t list = get_list_index(size); list < NUM_SEGREGATED_LISTS; ++list) {
+		for (FreeBlock* block = m_freeLists[list]; block != nullptr; block = block->next) {
+			// blocks are 16-byte aligned, larger alignments need a gap in front of the block, which
+			// has to be large enough to become a free block of its own
+			size_t blockGap = MemoryUtils::get_next_address_adjustment_with_header(block, alignment, HEADER_SIZE) - HEADER_SIZE;
+			if (blockGap != 0 && blockGap < MIN_BLOCK_SIZE)
+				blockGap += round_up(MIN_BLOCK_SIZE - blockGap, alignment);
+
+			if (block->size < blockGap + size) continue;
+
+			if (m_policy != BEST_FIT) {
+				gap = blockGap;
+				return block;
+			}
+
+			if (bestBlock == nullptr || block->size < bestSize) {
+				bestBlock = block;
+				bestSize = block->size;
+				bestGap = blockGap;
+
+				// nothing can fit better than an exact match
+				if (bestSize == blockGap + size) break;
+			}
+		}
+
+		// only SEGREGATED_FIT uses more than the first list
+		if (m_policy != SEGREGATED_FIT) break;
+	}
+
+	gap = bestGap;
+	return bestBlock;
+}
+
+void* FreeListAllocator::__allocate(size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+
+	if (alignment < BLOCK_GRANULARITY) alignment = BLOCK_GRANULARITY;
+
+	size_t neededSize = round_up(size, BLOCK_GRANULARITY) + HEADER_SIZE;
+	size_t gap;
+	FreeBlock* block = find_free_block(neededSize, alignment, gap);
+
+	// return null pointer if there is no free block large enough
+	if (block == nullptr) return nullptr;
+
+	size_t blockSize = block->size;
+	remove_free_block(block, blockSize);
+
+	// split the alignment gap off the front as a separate free block
+	BlockHeader* header = block;
+	if (gap > 0) {
+		header = (BlockHeader*)MemoryUtils::add_to_pointer(block, gap);
+		header->previousSize = gap;
+		block->size = gap;
+		insert_free_block(block, gap);
+		blockSize -= gap;
+	}
+
+	// split the unused rest off the back if it is large enough to hold another block
+	if (blockSize - neededSize >= MIN_BLOCK_SIZE) {
+		FreeBlock* rest = (FreeBlock*)MemoryUtils::add_to_pointer(header, neededSize);
+		rest->previousSize = neededSize;
+		rest->size = blockSize - neededSize;
+		((BlockHeader*)MemoryUtils::add_to_pointer(rest, rest->size))->previousSize = rest->size;
+		insert_free_block(rest, rest->size);
+		blockSize = neededSize;
+	}
+
+	header->size = blockSize | USED_FLAG;
+	((BlockHeader*)MemoryUtils::add_to_pointer(header, blockSize))->previousSize = blockSize;
+
+	m_used_memory += blockSize;
+	++m_num_allocations;
+
+	return MemoryUtils::add_to_pointer(header, HEADER_SIZE);
+}
+
+void FreeListAllocator::__deallocate(void* ptr) {
+	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+	FreeBlock* block = (FreeBlock*)MemoryUtils::add_to_pointer(ptr, -HEADER_SIZE);
+	throw_assert(block->size & USED_FLAG, "deallocated pointer is not an allocated block");
+
+	size_t blockSize = block->size & ~USED_FLAG;
+	m_used_memory -= blockSize;
+	--m_num_allocations;
+
+	// merge with the following block
+	FreeBlock* next = (FreeBlock*)MemoryUtils::add_to_pointer(block, blockSize);
+	if (!(next->size & USED_FLAG)) {
+		remove_free_block(next, next->size);
+		blockSize += next->size;
+	}
+
+	// merge with the preceding block
+	if (block->previousSize != 0) {
+		FreeBlock* previous = (FreeBlock*)MemoryUtils::add_to_pointer(block, -block->previousSize);
+		if (!(previous->size & USED_FLAG)) {
+			remove_free_block(previous, previous->size);
+			blockSize += previous->size;
+			block = previous;
+		}
+	}
+
+	block->size = blockSize;
+	((BlockHeader*)MemoryUtils::add_to_pointer(block, blockSize))->previousSize = blockSize;
+	insert_free_block(block, blockSize);
+}
+
+bool FreeListAllocator::__try_expand_in_place(void* ptr, size_t old_size, size_t new_size) {
+	BlockHeader* header = (BlockHeader*)MemoryUtils::add_to_pointer(ptr, -HEADER_SIZE);
+	throw_assert(header->size & USED_FLAG, "resized pointer is not an allocated block");
+
+	size_t blockSize = header->size & ~USED_FLAG;
+	size_t neededSize = round_up(new_size, BLOCK_GRANULARITY) + HEADER_SIZE;
+
+	// the block can take over the free block following it
+	FreeBlock* next = (FreeBlock*)MemoryUtils::add_to_pointer(header, blockSize);
+	size_t availableSize = blockSize + (!(next->size & USED_FLAG) ? next->size : 0);
+	if (availableSize < neededSize) return false;
+
+	if (availableSize > blockSize)
+		remove_free_block(next, next->size);
+
+	// split the unused rest off the back if it is large enough to hold another block
+	size_t newBlockSize = availableSize;
+	if (availableSize - neededSize >= MIN_BLOCK_SIZE) {
+		FreeBlock* rest = (FreeBlock*)MemoryUtils::add_to_pointer(header, neededSize);
+		rest->previousSize = neededSize;
+		rest->size = availableSize - neededSize;
+		((BlockHeader*)MemoryUtils::add_to_pointer(rest, rest->size))->previousSize = rest->size;
+		insert_free_block(rest, rest->size);
+		newBlockSize = neededSize;
+	}
+
+	header->size = newBlockSize | USED_FLAG;
+	((BlockHeader*)MemoryUtils::add_to_pointer(header, newBlockSize))->previousSize = newBlockSize;
+	m_used_memory = m_used_memory - blockSize + newBlockSize;
+
+	return true;
+}
+
+void FreeListAllocator::fill_stats(AllocatorStats& stats) const {
+	size_t freeMemory = 0;
+	size_t largestFreeBlock = 0;
+
+	// the usable part of a free block is what follows its header
+	for (size_t i = 0; i < NUM_SEGREGATED_LISTS; ++i) {
+		for (FreeBlock* block = m_freeLists[i]; block != nullptr; block = block->next) {
+			size_t usable = block->size - HEADER_SIZE;
+			freeMemory += usable;
+			largestFreeBlock = (usable > largestFreeBlock ? usable : largestFreeBlock);
+		}
+	}
+
+	stats.set_free_space(freeMemory, largestFreeBlock);
+}
\ No newline at end of file
@@ -1,37 +1,177 @@
-#include <LinearAllocator.h>
-
-using namespace SimpleMemoryAllocator;
-
-LinearAllocator::LinearAllocator(size_t memory_size) : BaseAllocator(nullptr, memory_size), m_firstFree(m_start) { }
-
-LinearAllocator::LinearAllocator(void* memory_ptr, size_t memory_size) : BaseAllocator(memory_ptr, memory_size), m_firstFree(m_start) { }
-
-LinearAllocator::~LinearAllocator() {
-	m_firstFree = nullptr;
-}
-
-void* LinearAllocator::__allocate(size_t size, uint8_t alignment) {
-	throw_assert(size > 0, "allocated size must be larger than 0");
-
-	uint8_t adjustment = MemoryUtils::get_next_address_adjustment(m_firstFree, alignment);
-
-	// don't allocate if we need to allocate more than we have free
-	if (m_used_memory + size + adjustment > m_size) return nullptr;
-
-	void* alignedAddress = MemoryUtils::add_to_pointer(m_firstFree, adjustment);
-	m_firstFree = MemoryUtils::add_to_pointer(alignedAddress, size);
-	m_used_memory += size + adjustment;
-	++m_num_allocations;
-
-	return alignedAddress;
-}
-
-void LinearAllocator::__deallocate(void* ptr) {
-	throw_assert(false, "method deallocate() is not usable in a linear allocator, use method clear() instead");
-}
-
-void LinearAllocator::clear() {
-	m_num_allocations = 0;
-	m_used_memory = 0;
-	m_firstFree = m_start;
+#include <LinearAllocator.h>
+
+using namespace SimpleMemoryAllocator;
+
+LinearAllocator::LinearAllocator(size_t memory_size, MemorySource* memory_source) : LinearAllocator(nullptr, memory_size, 0, 0, memory_source) { }
+
+LinearAllocator::LinearAllocator(void* memory_ptr, size_t memory_size) : LinearAllocator(memory_ptr, memory_size, 0, 0, nullptr) { }
+
+LinearAllocator::LinearAllocator(size_t memory_size, size_t max_memory_size, size_t max_kept_chunks, MemorySource* memory_source) : LinearAllocator(nullptr, memory_size, max_memory_size, max_kept_chunks, memory_source) { }
+
+LinearAllocator::LinearAllocator(void* memory_ptr, size_t memory_size, size_t max_memory_size, size_t max_kept_chunks) : LinearAllocator(memory_ptr, memory_size, max_memory_size, max_kept_chunks, nullptr) { }
+
+LinearAllocator::LinearAllocator(void* memory_ptr, size_t memory_size, size_t max_memory_size, size_t max_kept_chunks, MemorySource* memory_source)
+	: BaseAllocator(memory_ptr, memory_size, memory_source)
+	, m_firstFree(m_start)
+	, m_end(MemoryUtils::add_to_pointer(m_start, memory_size))
+	, m_chunks(nullptr)
+	, m_currentChunk(nullptr)
+	, m_capacity(memory_size)
+	, m_maxCapacity(max_memory_size)
+	, m_maxKeptChunks(max_kept_chunks) {
+
+	throw_assert(max_memory_size == 0 || max_memory_size >= memory_size, "linear allocator maximum size must not be smaller than its initial size");
+
+	// a relocated block stays where it was until clear()
+	m_deallocates_blocks = false;
+}
+
+LinearAllocator::~LinearAllocator() {
+	free_chunks(m_chunks);
+	m_chunks = nullptr;
+	m_currentChunk = nullptr;
+	m_firstFree = nullptr;
+}
+
+void* LinearAllocator::__allocate(size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+
+	size_t adjustment = MemoryUtils::get_next_address_adjustment(m_firstFree, alignment);
+
+	// don't allocate if we need to allocate more than we have free, unless we can grow
+	if ((char*)m_firstFree + adjustment + size > (char*)m_end) {
+		if (!grow(size, alignment)) return nullptr;
+
+		adjustment = MemoryUtils::get_next_address_adjustment(m_firstFree, alignment);
+	}
+
+	void* alignedAddress = MemoryUtils::add_to_pointer(m_firstFree, adjustment);
+	m_firstFree = MemoryUtils::add_to_pointer(alignedAddress, size);
+	m_used_memory += size + adjustment;
+	++m_num_allocations;
+
+	return alignedAddress;
+}
+
+void LinearAllocator::__deallocate(void* ptr) {
+	throw_assert(false, "method deallocate() is not usable in a linear allocator, use method clear() instead");
+}
+
+bool LinearAllocator::__try_expand_in_place(void* ptr, size_t old_size, size_t new_size) {
+	// only the last allocation can be resized, it ends at the nearest free address
+	if ((char*)ptr + old_size != (char*)m_firstFree) return false;
+	if ((size_t)((char*)m_end - (char*)ptr) < new_size) return false;
+
+	m_firstFree = MemoryUtils::add_to_pointer(ptr, new_size);
+	m_used_memory = m_used_memory - old_size + new_size;
+
+	return true;
+}
+
+bool LinearAllocator::grow(size_t size, size_t alignment) {
+	if (m_maxCapacity == 0) return false;
+
+	size_t neededSize = sizeof(LinearAllocatorChunk) + size + alignment;
+	LinearAllocatorChunk** link = (m_currentChunk != nullptr ? &m_currentChunk->next : &m_chunks);
+
+	// reuse a chunk kept by clear(), unless it is too small for this request
+	if (*link != nullptr && (*link)->size < neededSize) {
+		free_chunks(*link);
+		*link = nullptr;
+	}
+
+	if (*link == nullptr) {
+		// grow geometrically, but never past the cap
+		size_t lastSize = (m_currentChunk != nullptr ? m_currentChunk->size : m_size);
+		size_t chunkSize = (2 * lastSize > neededSize ? 2 * lastSize : neededSize);
+
+		if (m_capacity + neededSize > m_maxCapacity) return false;
+		if (m_capacity + chunkSize > m_maxCapacity) chunkSize = m_maxCapacity - m_capacity;
+
+		LinearAllocatorChunk* chunk = (LinearAllocatorChunk*)allocate_chunk(chunkSize);
+		if (chunk == nullptr) return false;
+
+		chunk->next = nullptr;
+		chunk->size = chunkSize;
+		*link = chunk;
+		m_capacity += chunkSize;
+	}
+
+	m_currentChunk = *link;
+	m_firstFree = MemoryUtils::add_to_pointer(m_currentChunk, sizeof(LinearAllocatorChunk));
+	m_end = MemoryUtils::add_to_pointer(m_currentChunk, m_currentChunk->size);
+
+	return true;
+}
+
+void LinearAllocator::free_chunks(LinearAllocatorChunk* chunk) {
+	while (chunk != nullptr) {
+		LinearAllocatorChunk* next = chunk->next;
+		m_capacity -= chunk->size;
+		deallocate_chunk(chunk, chunk->size);
+		chunk = next;
+	}
+}
+
+void LinearAllocator::clear() {
+	m_num_allocations = 0;
+	m_used_memory = 0;
+	m_firstFree = m_start;
+	m_end = MemoryUtils::add_to_pointer(m_start, m_size);
+	m_currentChunk = nullptr;
+
+	// keep only the first few chunks for reuse
+	LinearAllocatorChunk** link = &m_chunks;
+	for (size_t kept = 0; *link != nullptr && kept < m_maxKeptChunks; ++kept)
+		link = &(*link)->next;
+
+	free_chunks(*link);
+	*link = nullptr;
+}
+
+LinearAllocator::Marker LinearAllocator::get_marker() const noexcept {
+	return Marker{ m_firstFree, m_currentChunk, m_used_memory, m_num_allocations };
+}
+
+bool LinearAllocator::is_valid_marker(const Marker& marker) const noexcept {
+	if (marker.usedMemory > m_used_memory || marker.numAllocations > m_num_allocations) return false;
+
+	if (marker.chunk == m_currentChunk) return marker.position <= m_firstFree;
+	// the initial memory comes before every chunk
+	if (marker.chunk == nullptr) return true;
+	// the chunks after the current one are unused, even if they are kept
+	if (m_currentChunk == nullptr) return false;
+
+	for (LinearAllocatorChunk* chunk = m_chunks; chunk != m_currentChunk; chunk = chunk->next)
+		if (chunk == marker.chunk) return true;
+
+	return false;
+}
+
+void LinearAllocator::free_to_marker(const Marker& marker) {
+	throw_assert(is_valid_marker(marker), "marker must not be newer than the allocator state");
+
+	m_num_allocations = marker.numAllocations;
+	m_used_memory = marker.usedMemory;
+	m_firstFree = marker.position;
+	m_currentChunk = marker.chunk;
+
+	// the chunks after the current one stay chained, grow() moves on to them again
+	m_end = (m_currentChunk != nullptr ? MemoryUtils::add_to_pointer(m_currentChunk, m_currentChunk->size) : MemoryUtils::add_to_pointer(m_start, m_size));
+}
+
+void LinearAllocator::fill_stats(AllocatorStats& stats) const {
+	size_t freeMemory = (char*)m_end - (char*)m_firstFree;
+	size_t largestFreeBlock = freeMemory;
+
+	// chunks kept by clear() after the current one are unused as a whole
+	LinearAllocatorChunk* chunk = (m_currentChunk != nullptr ? m_currentChunk->next : m_chunks);
+	for (; chunk != nullptr; chunk = chunk->next) {
+		size_t chunkFree = chunk->size - sizeof(LinearAllocatorChunk);
+		freeMemory += chunkFree;
+		largestFreeBlock = (chunkFree > largestFreeBlock ? chunkFree : largestFreeBlock);
+	}
+
+	stats.capacity = m_capacity;
+	stats.set_free_space(freeMemory, largestFreeBlock);
 }
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include <MemorySource.h>
+#include <new>
+
+using namespace SimpleMemoryAllocator;
+
+MemorySource& MemorySource::get_default() {
+	static NewDeleteMemorySource source;
+	return source;
+}
+
+void* NewDeleteMemorySource::allocate_region(size_t size) {
+	return ::operator new(size, std::nothrow);
+}
+
+void NewDeleteMemorySource::deallocate_region(void* ptr, size_t size) {
+	::operator delete(ptr);
+}
+
+void* MmapMemorySource::allocate_region(size_t size) {
+	try {
+		return SystemMemory::map(size, m_options);
+	} catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+
+void MmapMemorySource::deallocate_region(void* ptr, size_t size) {
+	SystemMemory::unmap(ptr, size, m_options);
+}
@@ -0,0 +1,213 @@
+#include <PerCpuCache.h>
+#include <atomic>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#if defined(__has_include)
+#if __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#endif
+#endif
+#endif
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* The magazines of a single CPU, one for every size class, on their own cache lines.
+	*/
+	struct alignas(64) PerCpuShard {
+		std::atomic<bool>   locked;     /// spin lock guarding the magazines
+		size_t*             counts;     /// number of cached blocks of every size class
+		void**              blocks;     /// cached blocks, a run of the magazine capacity for every size class
+	};
+
+}
+
+using namespace SimpleMemoryAllocator;
+
+namespace {
+	size_t get_num_cpus() {
+#if defined(__linux__)
+		// the configured CPUs, the online ones may have gaps in their numbering
+		long numCpus = sysconf(_SC_NPROCESSORS_CONF);
+		return (numCpus > 0 ? (size_t)numCpus : 1);
+#else
+		unsigned numCpus = std::thread::hardware_concurrency();
+		return (numCpus > 0 ? numCpus : 1);
+#endif
+	}
+
+	size_t get_current_cpu() {
+#if defined(__linux__) && defined(RSEQ_SIG)
+		// the kernel keeps the CPU id in the rseq area of every thread up to date, reading it costs a single load
+		if (__rseq_size > 0) {
+			const volatile struct rseq* area = (const struct rseq*)((char*)__builtin_thread_pointer() + __rseq_offset);
+			int32_t cpu = (int32_t)area->cpu_id;
+			if (cpu >= 0) return (size_t)cpu;
+		}
+#endif
+#if defined(__linux__)
+		int cpu = sched_getcpu();
+		return (cpu >= 0 ? (size_t)cpu : 0);
+#else
+		// no way to ask for the CPU, the threads are at least spread over the shards
+		return std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+	}
+
+	void lock_shard(PerCpuShard& shard) {
+		for (;;) {
+			if (!shard.locked.exchange(true, std::memory_order_acquire)) return;
+
+			// wait for the release without writing to the cache line
+			while (shard.locked.load(std::memory_order_relaxed))
+				std::this_thread::yield();
+		}
+	}
+
+	inline void unlock_shard(PerCpuShard& shard) {
+		shard.locked.store(false, std::memory_order_release);
+	}
+}
+
+PerCpuCache::PerCpuCache(PoolAllocator& pool, size_t batch_size) : PerCpuCache(pool, nullptr, pool.get_object_size(), pool.get_element_alignment(), 1, batch_size) { }
+
+PerCpuCache::PerCpuCache(SlabAllocator& slab, size_t batch_size) : PerCpuCache(slab, &slab, 0, 0, SlabAllocator::NUM_SIZE_CLASSES, batch_size) { }
+
+PerCpuCache::PerCpuCache(BaseAllocator& allocator, SlabAllocator* slab, size_t object_size, size_t object_alignment, size_t num_classes, size_t batch_size)
+	: m_allocator(allocator)
+	, m_slab(slab)
+	, m_objectSize(object_size)
+	, m_objectAlignment(object_alignment)
+	, m_numClasses(num_classes)
+	, m_batchSize(batch_size)
+	, m_numShards(get_num_cpus()) {
+
+	throw_assert(batch_size > 0, "per-CPU cache batch size must be larger than 0");
+
+	m_shards = new PerCpuShard[m_numShards];
+	for (size_t i = 0; i < m_numShards; ++i) {
+		m_shards[i].locked.store(false, std::memory_order_relaxed);
+		m_shards[i].counts = new size_t[m_numClasses]();
+		m_shards[i].blocks = new void*[m_numClasses * 2 * m_batchSize];
+	}
+}
+
+PerCpuCache::~PerCpuCache() {
+	flush();
+
+	for (size_t i = 0; i < m_numShards; ++i) {
+		delete[] m_shards[i].counts;
+		delete[] m_shards[i].blocks;
+	}
+
+	delete[] m_shards;
+	m_shards = nullptr;
+}
+
+PerCpuShard& PerCpuCache::lock_current_shard() {
+	PerCpuShard& shard = m_shards[get_current_cpu() % m_numShards];
+	lock_shard(shard);
+	return shard;
+}
+
+size_t PerCpuCache::get_class_size(size_t size_class) const noexcept {
+	return (m_slab != nullptr ? SlabAllocator::get_size_class_size(size_class) : m_objectSize);
+}
+
+void PerCpuCache::refill(PerCpuShard& shard, size_t size_class) {
+	size_t& count = shard.counts[size_class];
+	if (count >= m_batchSize) return;
+
+	// a slab allocator picks the size class from the size alone, any alignment of the class is guaranteed
+	void** magazine = shard.blocks + size_class * 2 * m_batchSize;
+	size_t alignment = (m_slab != nullptr ? 1 : m_objectAlignment);
+	count += m_allocator.allocate_raw_batch_thread_safe(magazine + count, m_batchSize - count, get_class_size(size_class), alignment);
+}
+
+void PerCpuCache::drain(PerCpuShard& shard, size_t size_class, size_t count) {
+	size_t& cached = shard.counts[size_class];
+	void** magazine = shard.blocks + size_class * 2 * m_batchSize;
+
+	// give back the least recently freed blocks, the hot ones stay cached
+	m_allocator.deallocate_raw_batch_thread_safe(magazine, count);
+
+	cached -= count;
+	for (size_t i = 0; i < cached; ++i)
+		magazine[i] = magazine[i + count];
+}
+
+void* PerCpuCache::allocate_raw(size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+
+	size_t sizeClass;
+	if (m_slab != nullptr) {
+		sizeClass = SlabAllocator::get_size_class(size, alignment);
+
+		// return null pointer if the request is larger than the largest size class
+		if (sizeClass == m_numClasses) return nullptr;
+	} else {
+		// a request that does not fit in a pool block would overwrite the neighbouring one
+		if (size > m_objectSize || alignment > m_objectAlignment) return nullptr;
+		sizeClass = 0;
+	}
+
+	PerCpuShard& shard = lock_current_shard();
+
+	if (shard.counts[sizeClass] == 0)
+		refill(shard, sizeClass);
+
+	// the shared allocator is exhausted as well
+	void* ptr = nullptr;
+	if (shard.counts[sizeClass] > 0)
+		ptr = shard.blocks[sizeClass * 2 * m_batchSize + --shard.counts[sizeClass]];
+
+	unlock_shard(shard);
+	return ptr;
+}
+
+void PerCpuCache::deallocate_raw(void* ptr) {
+	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+	size_t sizeClass = (m_slab != nullptr ? m_slab->get_size_class_of(ptr) : 0);
+
+	PerCpuShard& shard = lock_current_shard();
+
+	if (shard.counts[sizeClass] == 2 * m_batchSize)
+		drain(shard, sizeClass, m_batchSize);
+
+	shard.blocks[sizeClass * 2 * m_batchSize + shard.counts[sizeClass]++] = ptr;
+
+	unlock_shard(shard);
+}
+
+void PerCpuCache::flush() {
+	for (size_t i = 0; i < m_numShards; ++i) {
+		PerCpuShard& shard = m_shards[i];
+		lock_shard(shard);
+
+		for (size_t sizeClass = 0; sizeClass < m_numClasses; ++sizeClass) {
+			if (shard.counts[sizeClass] > 0)
+				drain(shard, sizeClass, shard.counts[sizeClass]);
+		}
+
+		unlock_shard(shard);
+	}
+}
+
+void PerCpuCache::lock_all() {
+	// in the same order as refill() and drain() take them
+	for (size_t i = 0; i < m_numShards; ++i)
+		lock_shard(m_shards[i]);
+
+	m_allocator.get_mutex().lock();
+}
+
+void PerCpuCache::unlock_all() {
+	m_allocator.get_mutex().unlock();
+
+	for (size_t i = m_numShards; i-- > 0;)
+		unlock_shard(m_shards[i]);
+}
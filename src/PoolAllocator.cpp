@@ -1,58 +1,161 @@
-#include <PoolAllocator.h>
-
-using namespace SimpleMemoryAllocator;
-
-template <class T>
-PoolAllocator::PoolAllocator(size_t pool_size) : PoolAllocator(nullptr, pool_size*sizeof(T) + alignof(T), sizeof(T), alignof(T)) { }
-
-template <class T>
-PoolAllocator::PoolAllocator(void* memory_ptr, size_t pool_size) : PoolAllocator(memory_ptr, pool_size*sizeof(T) + alignof(T), sizeof(T), alignof(T)) { }
-
-PoolAllocator::PoolAllocator(size_t memory_size, size_t objectSize, uint8_t object_alignment) : PoolAllocator(nullptr, memory_size, objectSize, object_alignment) { }
-
-PoolAllocator::PoolAllocator(void* memory_ptr, size_t memory_size, size_t objectSize, uint8_t object_alignment) : BaseAllocator(memory_ptr, memory_size) {
-	if (memory_ptr == nullptr)
-		memory_ptr = m_start;
-
-	uint8_t adjustment = MemoryUtils::get_next_address_adjustment(memory_ptr, object_alignment);
-
-	// align only at memory_ptr, this should make the rest automatically aligned
-	m_freeList = (void**)MemoryUtils::add_to_pointer(memory_ptr, adjustment);
-
-	// initialize the free cell linked list
-	// each node free node n initially points to node n+1 and the last node points to null
-	size_t numObjects = (memory_size - adjustment) / objectSize;
-	void** ptr = m_freeList;
-	for (size_t i = 0; i < numObjects - 1; ++i) {
-		*ptr = MemoryUtils::add_to_pointer(ptr, objectSize);
-		ptr = (void**) *ptr;
-	}
-	*ptr = nullptr;
-}
-
-PoolAllocator::~PoolAllocator() {
-	m_freeList = nullptr;
-}
-
-void* PoolAllocator::__allocate(size_t size, uint8_t alignment) {
-	throw_assert(size > 0, "allocated size must be larger than 0");
-
-	// return null pointer if there are no more cells left
-	if (m_freeList == nullptr) return nullptr;
-
-	void* ptr = m_freeList;				// get first free block
-	m_freeList = (void**)(*m_freeList);	// and then set the next free block as the first free block
-	m_used_memory += size;
-	++m_num_allocations;
-
-	return ptr;
-}
-
-void PoolAllocator::__deallocate(void* ptr) {
-	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
-
-	*((void**)ptr) = m_freeList;
-	m_freeList = (void**)ptr;
-	m_used_memory -= m_objectSize;
-	--m_num_allocations;
+#include <PoolAllocator.h>
+
+using namespace SimpleMemoryAllocator;
+
+PoolAllocator::PoolAllocator(size_t memory_size, size_t objectSize, size_t object_alignment, MemorySource* memory_source) : PoolAllocator(nullptr, memory_size, objectSize, object_alignment, 0, memory_source) { }
+
+PoolAllocator::PoolAllocator(void* memory_ptr, size_t memory_size, size_t objectSize, size_t object_alignment) : PoolAllocator(memory_ptr, memory_size, objectSize, object_alignment, 0, nullptr) { }
+
+PoolAllocator::PoolAllocator(size_t memory_size, size_t objectSize, size_t object_alignment, size_t max_memory_size, MemorySource* memory_source) : PoolAllocator(nullptr, memory_size, objectSize, object_alignment, max_memory_size, memory_source) { }
+
+PoolAllocator::PoolAllocator(void* memory_ptr, size_t memory_size, size_t objectSize, size_t object_alignment, size_t max_memory_size) : PoolAllocator(memory_ptr, memory_size, objectSize, object_alignment, max_memory_size, nullptr) { }
+
+PoolAllocator::PoolAllocator(void* memory_ptr, size_t memory_size, size_t objectSize, size_t object_alignment, size_t max_memory_size, MemorySource* memory_source)
+	: BaseAllocator(memory_ptr, memory_size, memory_source)
+	, m_freeList(nullptr)
+	, m_objectSize(MemoryUtils::get_aligned_size(objectSize, object_alignment))
+	, m_objectAlignment(object_alignment)
+	, m_chunks(nullptr)
+	, m_capacity(memory_size)
+	, m_maxCapacity(max_memory_size) {
+
+	throw_assert(objectSize >= sizeof(void*), "pool element must be able to hold a free list pointer");
+	throw_assert(MemoryUtils::is_valid_alignment(object_alignment), "pool element alignment must be a power of two");
+	throw_assert(max_memory_size == 0 || max_memory_size >= memory_size, "pool allocator maximum size must not be smaller than its initial size");
+
+	// the element size is a multiple of the object alignment, so the elements may share a larger one, and
+	// the chunks added later are aligned to it as well, requests up to it can then be served by any element
+	void* firstElement = MemoryUtils::add_to_pointer(m_start, MemoryUtils::get_next_address_adjustment(m_start, object_alignment));
+	m_elementAlignment = MemoryUtils::get_guaranteed_alignment(firstElement, m_objectSize);
+
+	// the free list is empty, elements are taken from the unused range until it runs out
+	set_unused_range(m_start, memory_size);
+}
+
+PoolAllocator::~PoolAllocator() {
+	while (m_chunks != nullptr) {
+		PoolAllocatorChunk* next = m_chunks->next;
+		deallocate_chunk(m_chunks, m_chunks->size);
+		m_chunks = next;
+	}
+
+	m_freeList = nullptr;
+}
+
+void PoolAllocator::set_unused_range(void* memory_ptr, size_t memory_size) {
+	size_t adjustment = MemoryUtils::get_next_address_adjustment(memory_ptr, m_elementAlignment);
+
+	// align only at memory_ptr, the element size is a multiple of the alignment, so the rest is aligned as well
+	size_t numObjects = (memory_size > adjustment ? (memory_size - adjustment) / m_objectSize : 0);
+	m_nextUnused = MemoryUtils::add_to_pointer(memory_ptr, adjustment);
+	m_unusedEnd = MemoryUtils::add_to_pointer(m_nextUnused, numObjects * m_objectSize);
+}
+
+bool PoolAllocator::grow() {
+	// each chunk has to hold at least a single element
+	size_t neededSize = sizeof(PoolAllocatorChunk) + m_objectSize + m_elementAlignment;
+	size_t lastSize = (m_chunks != nullptr ? m_chunks->size : m_size);
+	size_t chunkSize = (2 * lastSize > neededSize ? 2 * lastSize : neededSize);
+
+	if (m_capacity + neededSize > m_maxCapacity) return false;
+	if (m_capacity + chunkSize > m_maxCapacity) chunkSize = m_maxCapacity - m_capacity;
+
+	PoolAllocatorChunk* chunk = (PoolAllocatorChunk*)allocate_chunk(chunkSize);
+	if (chunk == nullptr) return false;
+
+	chunk->next = m_chunks;
+	chunk->size = chunkSize;
+	m_chunks = chunk;
+	m_capacity += chunkSize;
+
+	set_unused_range(MemoryUtils::add_to_pointer(chunk, sizeof(PoolAllocatorChunk)), chunkSize - sizeof(PoolAllocatorChunk));
+
+	return true;
+}
+
+void* PoolAllocator::__allocate(size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+
+	// a request that does not fit in an element would overwrite the neighbouring one
+	if (size > m_objectSize || alignment > m_elementAlignment) return nullptr;
+
+	void* ptr;
+
+	if (m_freeList != nullptr) {
+		ptr = m_freeList;					// get first free block
+		m_freeList = (void**)(*m_freeList);	// and then set the next free block as the first free block
+	} else {
+		// return null pointer if there are no more cells left and the pool cannot grow
+		if (m_nextUnused == m_unusedEnd && !grow()) return nullptr;
+
+		ptr = m_nextUnused;
+		m_nextUnused = MemoryUtils::add_to_pointer(m_nextUnused, m_objectSize);
+	}
+
+	m_used_memory += m_objectSize;		// a whole pool element is always used, no matter the requested size
+	++m_num_allocations;
+
+	return ptr;
+}
+
+void PoolAllocator::__deallocate(void* ptr) {
+	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+	*((void**)ptr) = m_freeList;
+	m_freeList = (void**)ptr;
+	m_used_memory -= m_objectSize;
+	--m_num_allocations;
+}
+
+size_t PoolAllocator::__allocate_batch(void** out, size_t count, size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+
+	if (size > m_objectSize || alignment > m_elementAlignment) return 0;
+
+	size_t allocated = 0;
+
+	while (allocated < count) {
+		// never used elements first, they form a contiguous run
+		for (; allocated < count && m_nextUnused != m_unusedEnd; ++allocated) {
+			out[allocated] = m_nextUnused;
+			m_nextUnused = MemoryUtils::add_to_pointer(m_nextUnused, m_objectSize);
+		}
+
+		for (; allocated < count && m_freeList != nullptr; ++allocated) {
+			out[allocated] = m_freeList;
+			m_freeList = (void**)(*m_freeList);
+		}
+
+		if (allocated < count && !grow()) break;
+	}
+
+	m_used_memory += allocated * m_objectSize;
+	m_num_allocations += allocated;
+
+	return allocated;
+}
+
+void PoolAllocator::__deallocate_batch(void** blocks, size_t count) {
+	if (count == 0) return;
+
+	// chain the blocks together and put the whole chain in front of the free list at once
+	for (size_t i = 0; i < count; ++i) {
+		throw_assert(blocks[i] != nullptr, "deallocated pointer must not be null");
+		*((void**)blocks[i]) = (i + 1 < count ? blocks[i + 1] : (void*)m_freeList);
+	}
+
+	m_freeList = (void**)blocks[0];
+	m_used_memory -= count * m_objectSize;
+	m_num_allocations -= count;
+}
+
+void PoolAllocator::fill_stats(AllocatorStats& stats) const {
+	size_t freeElements = ((char*)m_unusedEnd - (char*)m_nextUnused) / m_objectSize;
+	for (void** element = m_freeList; element != nullptr; element = (void**)(*element))
+		++freeElements;
+
+	stats.capacity = m_capacity;
+	stats.freeMemory = freeElements * m_objectSize;
+	stats.largestFreeBlock = (freeElements > 0 ? m_objectSize : 0);
+	stats.fragmentation = 0.0;     // any free element serves any request
 }
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include <RemoteFreePoolAllocator.h>
+
+using namespace SimpleMemoryAllocator;
+
+RemoteFreePoolAllocator::RemoteFreePoolAllocator(size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source) : RemoteFreePoolAllocator(nullptr, memory_size, object_size, object_alignment, memory_source) { }
+
+RemoteFreePoolAllocator::RemoteFreePoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment) : RemoteFreePoolAllocator(memory_ptr, memory_size, object_size, object_alignment, nullptr) { }
+
+RemoteFreePoolAllocator::RemoteFreePoolAllocator(void* memory_ptr, size_t memory_size, size_t object_size, size_t object_alignment, MemorySource* memory_source)
+	: BaseAllocator(memory_ptr, memory_size, memory_source)
+	, m_remoteFreeList(nullptr)
+	, m_freeList(nullptr)
+	, m_objectSize(MemoryUtils::get_aligned_size(object_size, object_alignment))
+	, m_objectAlignment(object_alignment)
+	, m_owner(std::this_thread::get_id()) {
+
+	throw_assert(object_size >= sizeof(void*), "pool element must be able to hold a free list pointer");
+	throw_assert(MemoryUtils::is_valid_alignment(object_alignment), "pool element alignment must be a power of two");
+
+	// align only the first element, the element size is a multiple of the alignment, so the rest is aligned as well
+	size_t adjustment = MemoryUtils::get_next_address_adjustment(m_start, object_alignment);
+	m_capacity = (memory_size > adjustment ? (memory_size - adjustment) / m_objectSize : 0);
+	m_nextUnused = MemoryUtils::add_to_pointer(m_start, adjustment);
+	m_unusedEnd = MemoryUtils::add_to_pointer(m_nextUnused, m_capacity * m_objectSize);
+
+	// requests up to the alignment all elements share can be served by any element
+	m_elementAlignment = MemoryUtils::get_guaranteed_alignment(m_nextUnused, m_objectSize);
+
+#ifdef SIMPLE_MEMORY_ALLOCATOR_STATS
+	// the shared BaseAllocator statistics cannot be updated from several threads at once
+	m_record_stats = false;
+#endif
+}
+
+RemoteFreePoolAllocator::~RemoteFreePoolAllocator() {
+	reclaim_remote_frees();
+	m_freeList = nullptr;
+}
+
+size_t RemoteFreePoolAllocator::reclaim_remote_frees() {
+	// a single consumer takes the whole list at once, so the list cannot suffer from the ABA problem
+	void** remote = (void**)m_remoteFreeList.exchange(nullptr, std::memory_order_acquire);
+	if (remote == nullptr) return 0;
+
+	// find the tail and append the local free list behind it
+	size_t count = 1;
+	void** tail = remote;
+	for (; *tail != nullptr; tail = (void**)(*tail))
+		++count;
+
+	*tail = m_freeList;
+	m_freeList = remote;
+	m_used_memory -= count * m_objectSize;
+	m_num_allocations -= count;
+
+	return count;
+}
+
+void* RemoteFreePoolAllocator::__allocate(size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+	throw_assert(is_owner_thread(), "only the owner thread can allocate from a remote free pool");
+
+	// a request that does not fit in an element would overwrite the neighbouring one
+	if (size > m_objectSize || alignment > m_elementAlignment) return nullptr;
+
+	void* ptr;
+
+	// the remotely deallocated elements are taken in bulk once the local ones run out
+	if (m_freeList == nullptr)
+		reclaim_remote_frees();
+
+	if (m_freeList != nullptr) {
+		ptr = m_freeList;
+		m_freeList = (void**)(*m_freeList);
+	} else {
+		// return null pointer if there are no more elements left
+		if (m_nextUnused == m_unusedEnd) return nullptr;
+
+		ptr = m_nextUnused;
+		m_nextUnused = MemoryUtils::add_to_pointer(m_nextUnused, m_objectSize);
+	}
+
+	m_used_memory += m_objectSize;
+	++m_num_allocations;
+
+	return ptr;
+}
+
+void RemoteFreePoolAllocator::__deallocate(void* ptr) {
+	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+	if (is_owner_thread()) {
+		*((void**)ptr) = m_freeList;
+		m_freeList = (void**)ptr;
+		m_used_memory -= m_objectSize;
+		--m_num_allocations;
+		return;
+	}
+
+	// any number of foreign threads push onto the remote free list, the counters are updated by the owner
+	void* head = m_remoteFreeList.load(std::memory_order_relaxed);
+	do {
+		*((void**)ptr) = head;
+	} while (!m_remoteFreeList.compare_exchange_weak(head, ptr, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void RemoteFreePoolAllocator::__deallocate_batch(void** blocks, size_t count) {
+	if (count == 0) return;
+
+	// chain the blocks together, the whole chain then goes to either list at once
+	for (size_t i = 0; i + 1 < count; ++i) {
+		throw_assert(blocks[i] != nullptr, "deallocated pointer must not be null");
+		*((void**)blocks[i]) = blocks[i + 1];
+	}
+	throw_assert(blocks[count - 1] != nullptr, "deallocated pointer must not be null");
+	void** last = (void**)blocks[count - 1];
+
+	if (is_owner_thread()) {
+		*last = m_freeList;
+		m_freeList = (void**)blocks[0];
+		m_used_memory -= count * m_objectSize;
+		m_num_allocations -= count;
+		return;
+	}
+
+	void* head = m_remoteFreeList.load(std::memory_order_relaxed);
+	do {
+		*last = head;
+	} while (!m_remoteFreeList.compare_exchange_weak(head, blocks[0], std::memory_order_release, std::memory_order_relaxed));
+}
+
+void RemoteFreePoolAllocator::fill_stats(AllocatorStats& stats) const {
+	size_t freeElements = ((char*)m_unusedEnd - (char*)m_nextUnused) / m_objectSize;
+	for (void** element = m_freeList; element != nullptr; element = (void**)(*element))
+		++freeElements;
+
+	stats.capacity = m_capacity * m_objectSize;
+	stats.freeMemory = freeElements * m_objectSize;
+	stats.largestFreeBlock = (freeElements > 0 ? m_objectSize : 0);
+	stats.fragmentation = 0.0;     // any free element serves any request
+}
@@ -0,0 +1,237 @@
+#include <SlabAllocator.h>
+#include <new>
+
+using namespace SimpleMemoryAllocator;
+
+/**
+* Bookkeeping of a single slab. An unused slab has no pool and is linked in the free slab list,
+* a slab in use hosts the pool of its size class and is linked in the partial list of the class
+* as long as the pool has free space.
+*/
+struct SlabAllocator::Slab {
+	alignas(PoolAllocator) unsigned char poolStorage[sizeof(PoolAllocator)];   /// storage of the slab pool
+	PoolAllocator*  pool;           /// the slab pool, null if the slab is unused
+	size_t          next;           /// next slab in the free or partial list
+	size_t          previous;       /// previous slab in the partial list
+	size_t          capacity;       /// number of objects the slab pool can hold
+	uint8_t         sizeClass;      /// size class served by the slab
+	bool            partial;        /// whether the slab is linked in the partial list
+};
+
+namespace {
+	const size_t NO_SLAB = (size_t)-1;
+	const size_t SLAB_ALIGNMENT = 4096;
+
+	constexpr size_t SIZE_CLASSES[SlabAllocator::NUM_SIZE_CLASSES] = {
+		8, 16, 32, 48, 64, 80, 96, 112, 128,
+		160, 192, 224, 256,
+		320, 384, 448, 512,
+		640, 768, 896, 1024,
+		1280, 1536, 1792, 2048,
+		2560, 3072, 3584, 4096
+	};
+
+	// maps (size + 7) / 8 to the smallest size class able to hold the size
+	struct SizeClassLookup {
+		uint8_t classes[SlabAllocator::MAX_SIZE / 8 + 1];
+
+		constexpr SizeClassLookup() : classes() {
+			size_t sizeClass = 0;
+			for (size_t i = 0; i <= SlabAllocator::MAX_SIZE / 8; ++i) {
+				while (SIZE_CLASSES[sizeClass] < i * 8)
+					++sizeClass;
+				classes[i] = (uint8_t)sizeClass;
+			}
+		}
+	};
+
+	// built at compile time, so that it is usable during static initialization as well
+	constexpr SizeClassLookup g_sizeClassLookup;
+
+	// the largest power of two dividing the class size, slots of the class are aligned to it
+	inline size_t get_size_class_alignment(size_t size_class) {
+		size_t size = SIZE_CLASSES[size_class];
+		size_t alignment = size & (~size + 1);
+		return (alignment < SLAB_ALIGNMENT ? alignment : SLAB_ALIGNMENT);
+	}
+}
+
+size_t SlabAllocator::get_size_class(size_t size, size_t alignment) {
+	if (size > MAX_SIZE) return NUM_SIZE_CLASSES;
+
+	size_t sizeClass = g_sizeClassLookup.classes[(size + 7) / 8];
+
+	// pick a larger class if the natural alignment of this one is not enough
+	while (sizeClass < NUM_SIZE_CLASSES && get_size_class_alignment(sizeClass) < alignment)
+		++sizeClass;
+
+	return sizeClass;
+}
+
+size_t SlabAllocator::get_size_class_size(size_t size_class) {
+	return SIZE_CLASSES[size_class];
+}
+
+size_t SlabAllocator::get_size_class_of(const void* ptr) const {
+	size_t slab = ((const char*)ptr - (const char*)m_slabsStart) / m_slabSize;
+	throw_assert(ptr >= m_slabsStart && slab < m_numSlabs && m_slabs[slab].pool != nullptr, "pointer does not belong to the allocator");
+
+	return m_slabs[slab].sizeClass;
+}
+
+SlabAllocator::SlabAllocator(size_t memory_size, size_t slab_size, MemorySource* memory_source) : SlabAllocator(nullptr, memory_size, slab_size, memory_source) { }
+
+SlabAllocator::SlabAllocator(void* memory_ptr, size_t memory_size, size_t slab_size) : SlabAllocator(memory_ptr, memory_size, slab_size, nullptr) { }
+
+SlabAllocator::SlabAllocator(void* memory_ptr, size_t memory_size, size_t slab_size, MemorySource* memory_source) : BaseAllocator(memory_ptr, memory_size, memory_source), m_slabSize(slab_size) {
+	throw_assert(slab_size >= MAX_SIZE, "slab size must be able to hold the largest size class");
+	// every slab then starts page aligned, so its pool needs no alignment adjustment and holds exactly slab_size / class size objects
+	throw_assert(slab_size % SLAB_ALIGNMENT == 0, "slab size must be a multiple of 4096");
+
+	size_t adjustment = (SLAB_ALIGNMENT - ((uintptr_t)m_start & (SLAB_ALIGNMENT - 1))) & (SLAB_ALIGNMENT - 1);
+	m_slabsStart = MemoryUtils::add_to_pointer(m_start, adjustment);
+	m_numSlabs = (memory_size > adjustment ? (memory_size - adjustment) / slab_size : 0);
+	throw_assert(m_numSlabs > 0, "slab allocator memory must hold at least one slab");
+
+	m_slabs = new Slab[m_numSlabs];
+
+	// all slabs are unused at first
+	for (size_t i = 0; i < m_numSlabs; ++i) {
+		m_slabs[i].pool = nullptr;
+		m_slabs[i].next = (i + 1 < m_numSlabs ? i + 1 : NO_SLAB);
+		m_slabs[i].partial = false;
+	}
+	m_freeSlabs = 0;
+
+	for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i)
+		m_partialSlabs[i] = NO_SLAB;
+}
+
+SlabAllocator::~SlabAllocator() {
+	for (size_t i = 0; i < m_numSlabs; ++i) {
+		if (m_slabs[i].pool != nullptr)
+			m_slabs[i].pool->~PoolAllocator();
+	}
+
+	delete[] m_slabs;
+	m_slabs = nullptr;
+}
+
+void SlabAllocator::link_partial_slab(size_t slab) {
+	size_t& head = m_partialSlabs[m_slabs[slab].sizeClass];
+
+	m_slabs[slab].previous = NO_SLAB;
+	m_slabs[slab].next = head;
+	if (head != NO_SLAB)
+		m_slabs[head].previous = slab;
+	head = slab;
+	m_slabs[slab].partial = true;
+}
+
+void SlabAllocator::unlink_partial_slab(size_t slab) {
+	Slab& info = m_slabs[slab];
+
+	if (info.previous != NO_SLAB)
+		m_slabs[info.previous].next = info.next;
+	else
+		m_partialSlabs[info.sizeClass] = info.next;
+
+	if (info.next != NO_SLAB)
+		m_slabs[info.next].previous = info.previous;
+
+	info.partial = false;
+}
+
+void* SlabAllocator::__allocate(size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+
+	size_t sizeClass = get_size_class(size, alignment);
+
+	// return null pointer if the request is larger than the largest size class
+	if (sizeClass == NUM_SIZE_CLASSES) return nullptr;
+
+	size_t slab = m_partialSlabs[sizeClass];
+	if (slab == NO_SLAB) {
+		// return null pointer if there are no more slabs left
+		slab = m_freeSlabs;
+		if (slab == NO_SLAB) return nullptr;
+
+		m_freeSlabs = m_slabs[slab].next;
+
+		// carve a new pool for the size class from the slab
+		Slab& info = m_slabs[slab];
+		void* slabStart = MemoryUtils::add_to_pointer(m_slabsStart, slab * m_slabSize);
+		info.pool = new (info.poolStorage) PoolAllocator(slabStart, m_slabSize, SIZE_CLASSES[sizeClass], get_size_class_alignment(sizeClass));
+		info.capacity = m_slabSize / SIZE_CLASSES[sizeClass];
+		info.sizeClass = (uint8_t)sizeClass;
+		link_partial_slab(slab);
+	}
+
+	Slab& info = m_slabs[slab];
+	void* ptr = info.pool->allocate_raw(SIZE_CLASSES[sizeClass], get_size_class_alignment(sizeClass));
+	if (ptr == nullptr) return nullptr;
+
+	if (info.pool->get_num_allocations() == info.capacity)
+		unlink_partial_slab(slab);
+
+	m_used_memory += SIZE_CLASSES[sizeClass];
+	++m_num_allocations;
+
+	return ptr;
+}
+
+void SlabAllocator::__deallocate(void* ptr) {
+	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+	size_t slab = ((char*)ptr - (char*)m_slabsStart) / m_slabSize;
+	throw_assert(ptr >= m_slabsStart && slab < m_numSlabs && m_slabs[slab].pool != nullptr, "deallocated pointer does not belong to the allocator");
+
+	Slab& info = m_slabs[slab];
+	info.pool->deallocate_raw(ptr);
+	m_used_memory -= SIZE_CLASSES[info.sizeClass];
+	--m_num_allocations;
+
+	if (info.pool->get_num_allocations() == 0) {
+		// keep the last partial slab of the class, so that a single allocation going back
+		// and forth does not rebuild the pool every time
+		if (info.partial && info.previous == NO_SLAB && info.next == NO_SLAB)
+			return;
+
+		// give the empty slab back for any size class to reuse
+		if (info.partial)
+			unlink_partial_slab(slab);
+
+		info.pool->~PoolAllocator();
+		info.pool = nullptr;
+		info.next = m_freeSlabs;
+		m_freeSlabs = slab;
+	} else if (!info.partial) {
+		link_partial_slab(slab);
+	}
+}
+
+void SlabAllocator::fill_stats(AllocatorStats& stats) const {
+	size_t freeMemory = 0;
+	size_t partialMemory = 0;
+	size_t largestFreeBlock = 0;
+
+	for (size_t i = 0; i < m_numSlabs; ++i) {
+		const Slab& info = m_slabs[i];
+
+		if (info.pool == nullptr) {
+			// an unused slab can serve any size class
+			freeMemory += m_slabSize;
+			largestFreeBlock = MAX_SIZE;
+		} else if (info.partial) {
+			size_t classSize = SIZE_CLASSES[info.sizeClass];
+			partialMemory += (info.capacity - info.pool->get_num_allocations()) * classSize;
+			largestFreeBlock = (classSize > largestFreeBlock ? classSize : largestFreeBlock);
+		}
+	}
+
+	stats.capacity = m_numSlabs * m_slabSize;
+	stats.set_free_space(freeMemory + partialMemory, largestFreeBlock);
+
+	// the free space of the partial slabs is only usable by their own size class
+	stats.fragmentation = (stats.freeMemory > 0 ? (double)partialMemory / stats.freeMemory : 0.0);
+}
\ No newline at end of file
@@ -1,43 +1,72 @@
-#include <StackAllocator.h>
-
-using namespace SimpleMemoryAllocator;
-
-StackAllocator::StackAllocator(size_t memory_size) : StackAllocator(nullptr, memory_size) { }
-
-StackAllocator::StackAllocator(void* memory_ptr, size_t memory_size) : BaseAllocator(memory_ptr, memory_size), m_top(m_start), m_previousTop(nullptr) {  }
-
-StackAllocator::~StackAllocator() {
-	m_top = nullptr;
-	m_previousTop = nullptr;
-}
-
-void* StackAllocator::__allocate(size_t size, uint8_t alignment) {
-	throw_assert(size > 0, "allocated size must be larger than 0");
-
-	uint8_t adjustment = MemoryUtils::get_next_address_adjustment_with_header(m_top, alignment, sizeof(StackAllocationHeader));
-
-	// don't allocate if we need to allocate more than we have free
-	if (m_used_memory + size + adjustment > m_size) return nullptr;
-
-	void* alignedAddress = MemoryUtils::add_to_pointer(m_top, adjustment);
-
-	// store allocation header before the actual stored data
-	StackAllocationHeader* header = (StackAllocationHeader*)MemoryUtils::add_to_pointer(alignedAddress, -sizeof(StackAllocationHeader));
-	header->adjustment = adjustment;
-
-	m_previousTop = m_top;
-	m_top = MemoryUtils::add_to_pointer(alignedAddress, size);
-	m_used_memory += size + adjustment;
-	++m_num_allocations;
-
-	return (void*)alignedAddress;
-}
-
-void StackAllocator::__deallocate(void* ptr) {
-	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
-
-	StackAllocationHeader* header = (StackAllocationHeader*)MemoryUtils::add_to_pointer(ptr, -sizeof(StackAllocationHeader));
-	m_used_memory -= ((unsigned*)m_top - (unsigned*)ptr + header->adjustment);
-	m_top = MemoryUtils::add_to_pointer(ptr, header->adjustment);
-	--m_num_allocations;
+#include <StackAllocator.h>
+
+using namespace SimpleMemoryAllocator;
+
+StackAllocator::StackAllocator(size_t memory_size, MemorySource* memory_source) : BaseAllocator(nullptr, memory_size, memory_source), m_top(m_start), m_previousTop(nullptr) { }
+
+StackAllocator::StackAllocator(void* memory_ptr, size_t memory_size) : BaseAllocator(memory_ptr, memory_size), m_top(m_start), m_previousTop(nullptr) {  }
+
+StackAllocator::~StackAllocator() {
+	m_top = nullptr;
+	m_previousTop = nullptr;
+}
+
+void* StackAllocator::__allocate(size_t size, size_t alignment) {
+	throw_assert(size > 0, "allocated size must be larger than 0");
+
+	// the header is accessed in place, so it has to be aligned itself
+	if (alignment < alignof(StackAllocationHeader)) alignment = alignof(StackAllocationHeader);
+
+	size_t adjustment = MemoryUtils::get_next_address_adjustment_with_header(m_top, alignment, sizeof(StackAllocationHeader));
+	throw_assert(adjustment <= UINT32_MAX, "alignment is too large for the stack allocation header");
+
+	// don't allocate if we need to allocate more than we have free
+	if (m_used_memory + size + adjustment > m_size) return nullptr;
+
+	void* alignedAddress = MemoryUtils::add_to_pointer(m_top, adjustment);
+
+	// store allocation header before the actual stored data
+	StackAllocationHeader* header = (StackAllocationHeader*)MemoryUtils::add_to_pointer(alignedAddress, -sizeof(StackAllocationHeader));
+	header->adjustment = (uint32_t)adjustment;
+
+	m_previousTop = m_top;
+	m_top = MemoryUtils::add_to_pointer(alignedAddress, size);
+	m_used_memory += size + adjustment;
+	++m_num_allocations;
+
+	return (void*)alignedAddress;
+}
+
+void StackAllocator::__deallocate(void* ptr) {
+	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+	StackAllocationHeader* header = (StackAllocationHeader*)MemoryUtils::add_to_pointer(ptr, -sizeof(StackAllocationHeader));
+	m_used_memory -= ((char*)m_top - (char*)ptr + header->adjustment);
+	m_top = MemoryUtils::add_to_pointer(ptr, -(size_t)header->adjustment);
+	--m_num_allocations;
+}
+
+bool StackAllocator::__try_expand_in_place(void* ptr, size_t old_size, size_t new_size) {
+	// only the block on the top of the stack can be resized
+	if (!is_last_allocation(ptr, old_size)) return false;
+	if (m_used_memory - old_size + new_size > m_size) return false;
+
+	m_top = MemoryUtils::add_to_pointer(ptr, new_size);
+	m_used_memory = m_used_memory - old_size + new_size;
+
+	return true;
+}
+
+bool StackAllocator::__can_deallocate_moved(const void* ptr, size_t size) const {
+	// deallocating a block below the top would release everything above it, including the new block,
+	// so it stays until the blocks below it are deallocated
+	return is_last_allocation(ptr, size);
+}
+
+void StackAllocator::free_to_marker(const Marker& marker) {
+	throw_assert(is_valid_marker(marker), "marker must lie between the bottom and the top of the stack");
+
+	m_top = marker.top;
+	m_used_memory = marker.usedMemory;
+	m_num_allocations = marker.numAllocations;
 }
\ No newline at end of file
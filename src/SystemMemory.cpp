@@ -0,0 +1,146 @@
+#include <SystemMemory.h>
+#include <AssertException.h>
+#include <MemUtils.h>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstdio>
+#include <vector>
+#endif
+
+using namespace SimpleMemoryAllocator;
+
+#if defined(__linux__)
+namespace {
+	const int MPOL_BIND_POLICY = 2;     // MPOL_BIND of <numaif.h>, which comes with libnuma and is not always installed
+
+	inline size_t round_up(size_t value, size_t multiple) {
+		return (value + multiple - 1) / multiple * multiple;
+	}
+
+	// mappings are made of whole pages of this size, both map() and unmap() have to agree on it
+	size_t get_mapping_granularity(const MmapOptions& options) {
+		if (options.hugePages == MmapOptions::NO_HUGE_PAGES) return SystemMemory::get_page_size();
+
+		size_t hugePageSize = (options.hugePageSize != 0 ? options.hugePageSize : SystemMemory::get_huge_page_size());
+		return (hugePageSize != 0 ? hugePageSize : SystemMemory::get_page_size());
+	}
+
+	bool bind_to_node(void* ptr, size_t size, int node) {
+#ifdef SYS_mbind
+		const size_t bitsPerWord = sizeof(unsigned long) * 8;
+		std::vector<unsigned long> nodeMask(node / bitsPerWord + 1, 0);
+		nodeMask[node / bitsPerWord] |= 1UL << (node % bitsPerWord);
+
+		return syscall(SYS_mbind, ptr, size, MPOL_BIND_POLICY, nodeMask.data(), nodeMask.size() * bitsPerWord + 1, 0) == 0;
+#else
+		return false;
+#endif
+	}
+
+	void prefault(void* ptr, size_t size) {
+#ifdef MADV_POPULATE_WRITE
+		if (madvise(ptr, size, MADV_POPULATE_WRITE) == 0) return;
+#endif
+		// older kernels, write to every page
+		const size_t pageSize = SystemMemory::get_page_size();
+		for (size_t offset = 0; offset < size; offset += pageSize)
+			static_cast<volatile char*>(ptr)[offset] = 0;
+	}
+}
+#endif
+
+void* SystemMemory::map(size_t size, const MmapOptions& options) {
+#if defined(__linux__)
+	const size_t granularity = get_mapping_granularity(options);
+	const size_t mappingSize = round_up(size, granularity);
+
+	// the pages have to be bound or advised before they are faulted in, MAP_POPULATE would fault them right away
+	const bool prefaultLater = options.populate && (options.numaNode >= 0 || options.hugePages == MmapOptions::TRANSPARENT_HUGE_PAGES);
+
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	if (options.populate && !prefaultLater) flags |= MAP_POPULATE;
+
+	void* ptr;
+
+	if (options.hugePages == MmapOptions::EXPLICIT_HUGE_PAGES) {
+		flags |= MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+		if (options.hugePageSize != 0)
+			flags |= (int)MemoryUtils::get_log2_floor(options.hugePageSize) << MAP_HUGE_SHIFT;
+#endif
+		ptr = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+		if (ptr == MAP_FAILED) throw std::bad_alloc();
+	} else if (options.hugePages == MmapOptions::TRANSPARENT_HUGE_PAGES) {
+		// map a huge page more and trim it, so that the block starts at a huge page boundary
+		void* raw = mmap(nullptr, mappingSize + granularity, PROT_READ | PROT_WRITE, flags, -1, 0);
+		if (raw == MAP_FAILED) throw std::bad_alloc();
+
+		uintptr_t aligned = round_up((uintptr_t)raw, granularity);
+		size_t head = aligned - (uintptr_t)raw;
+		if (head > 0) munmap(raw, head);
+		if (granularity - head > 0) munmap((void*)(aligned + mappingSize), granularity - head);
+
+		ptr = (void*)aligned;
+
+		// only a hint, transparent huge pages may be disabled
+		madvise(ptr, mappingSize, MADV_HUGEPAGE);
+	} else {
+		ptr = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+		if (ptr == MAP_FAILED) throw std::bad_alloc();
+	}
+
+	if (options.numaNode >= 0 && !bind_to_node(ptr, mappingSize, options.numaNode)) {
+		munmap(ptr, mappingSize);
+		throw_assert(false, "binding the memory to the NUMA node failed, the node may not exist");
+	}
+
+	if (prefaultLater)
+		prefault(ptr, mappingSize);
+
+	return ptr;
+#else
+	return ::operator new(size);
+#endif
+}
+
+void SystemMemory::unmap(void* ptr, size_t size, const MmapOptions& options) {
+#if defined(__linux__)
+	munmap(ptr, round_up(size, get_mapping_granularity(options)));
+#else
+	::operator delete(ptr);
+#endif
+}
+
+size_t SystemMemory::get_page_size() {
+#if defined(__linux__)
+	static const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	return pageSize;
+#else
+	return 4096;
+#endif
+}
+
+size_t SystemMemory::get_huge_page_size() {
+#if defined(__linux__)
+	static const size_t hugePageSize = []() {
+		size_t sizeKiB = 0;
+
+		if (FILE* meminfo = std::fopen("/proc/meminfo", "r")) {
+			char line[256];
+			while (std::fgets(line, sizeof(line), meminfo) != nullptr) {
+				if (std::sscanf(line, "Hugepagesize: %zu kB", &sizeKiB) == 1) break;
+			}
+			std::fclose(meminfo);
+		}
+
+		return sizeKiB * 1024;
+	}();
+	return hugePageSize;
+#else
+	return 0;
+#endif
+}
@@ -0,0 +1,181 @@
+#include <ThreadCache.h>
+#include <atomic>
+
+namespace SimpleMemoryAllocator {
+
+	/**
+	* A per-thread stack of free blocks belonging to a single ThreadCache.
+	*/
+	struct ThreadCacheMagazine {
+		uint64_t                cacheId;        /// identifier of the owning cache, never reused
+		ThreadCache*            owner;          /// owning cache, null once the cache was destroyed
+		ThreadCacheMagazine*    nextInThread;   /// next magazine of the same thread
+		ThreadCacheMagazine*    nextInCache;    /// next magazine of the same cache
+		size_t                  count;          /// number of cached blocks
+		size_t                  capacity;       /// maximum number of cached blocks
+		void*                   blocks[1];      /// cached blocks, the array continues past the end of the struct
+	};
+
+	/**
+	* Thread-local list of all magazines owned by a thread, returns them to their caches when the thread exits.
+	*/
+	struct ThreadCacheRegistry {
+		ThreadCacheMagazine* head = nullptr;
+
+		~ThreadCacheRegistry();
+	};
+
+}
+
+using namespace SimpleMemoryAllocator;
+
+namespace {
+	std::mutex                  g_registryMutex;    // guards ThreadCacheMagazine::owner and ThreadCache::m_magazines
+	std::atomic<uint64_t>       g_nextCacheId(1);
+
+	thread_local ThreadCacheRegistry    t_registry;
+	thread_local ThreadCacheMagazine*   t_lastMagazine = nullptr;   // the most recently used magazine of this thread
+
+	void unlink_from_cache(ThreadCacheMagazine** head, ThreadCacheMagazine* magazine) {
+		for (ThreadCacheMagazine** link = head; *link != nullptr; link = &(*link)->nextInCache) {
+			if (*link == magazine) {
+				*link = magazine->nextInCache;
+				return;
+			}
+		}
+	}
+}
+
+ThreadCacheRegistry::~ThreadCacheRegistry() {
+	std::lock_guard<std::mutex> lock(g_registryMutex);
+
+	while (head != nullptr) {
+		ThreadCacheMagazine* magazine = head;
+		head = magazine->nextInThread;
+
+		if (magazine->owner != nullptr) {
+			magazine->owner->drain(magazine, magazine->count);
+			unlink_from_cache(&magazine->owner->m_magazines, magazine);
+		}
+
+		::operator delete(magazine);
+	}
+
+	t_lastMagazine = nullptr;
+}
+
+ThreadCache::ThreadCache(PoolAllocator& pool, size_t batch_size)
+	: m_pool(pool)
+	, m_objectSize(pool.get_object_size())
+	, m_objectAlignment(pool.get_object_alignment())
+	, m_batchSize(batch_size)
+	, m_id(g_nextCacheId.fetch_add(1))
+	, m_magazines(nullptr) {
+
+	throw_assert(batch_size > 0, "thread cache batch size must be larger than 0");
+}
+
+ThreadCache::~ThreadCache() {
+	std::lock_guard<std::mutex> lock(g_registryMutex);
+
+	// the magazines themselves are owned by their threads, only detach them here
+	for (ThreadCacheMagazine* magazine = m_magazines; magazine != nullptr; magazine = magazine->nextInCache) {
+		drain(magazine, magazine->count);
+		magazine->owner = nullptr;
+	}
+
+	m_magazines = nullptr;
+}
+
+ThreadCacheMagazine* ThreadCache::get_magazine() {
+	ThreadCacheMagazine* magazine = t_lastMagazine;
+	if (magazine != nullptr && magazine->cacheId == m_id)
+		return magazine;
+
+	for (magazine = t_registry.head; magazine != nullptr; magazine = magazine->nextInThread) {
+		if (magazine->cacheId == m_id)
+			break;
+	}
+
+	if (magazine == nullptr)
+		magazine = create_magazine();
+
+	t_lastMagazine = magazine;
+	return magazine;
+}
+
+ThreadCacheMagazine* ThreadCache::create_magazine() {
+	std::lock_guard<std::mutex> lock(g_registryMutex);
+
+	// drop the magazines of already destroyed caches while we are at it
+	for (ThreadCacheMagazine** link = &t_registry.head; *link != nullptr; ) {
+		ThreadCacheMagazine* magazine = *link;
+		if (magazine->owner == nullptr) {
+			*link = magazine->nextInThread;
+			if (t_lastMagazine == magazine)
+				t_lastMagazine = nullptr;
+			::operator delete(magazine);
+		} else {
+			link = &magazine->nextInThread;
+		}
+	}
+
+	size_t capacity = 2 * m_batchSize;
+	ThreadCacheMagazine* magazine = (ThreadCacheMagazine*)::operator new(sizeof(ThreadCacheMagazine) + (capacity - 1) * sizeof(void*));
+	magazine->cacheId = m_id;
+	magazine->owner = this;
+	magazine->count = 0;
+	magazine->capacity = capacity;
+
+	magazine->nextInThread = t_registry.head;
+	t_registry.head = magazine;
+	magazine->nextInCache = m_magazines;
+	m_magazines = magazine;
+
+	return magazine;
+}
+
+void ThreadCache::refill(ThreadCacheMagazine* magazine) {
+	if (magazine->count >= m_batchSize) return;
+
+	size_t needed = m_batchSize - magazine->count;
+	magazine->count += m_pool.allocate_raw_batch_thread_safe(magazine->blocks + magazine->count, needed, m_objectSize, m_objectAlignment);
+}
+
+void ThreadCache::drain(ThreadCacheMagazine* magazine, size_t count) {
+	// give back the least recently freed blocks, the hot ones stay cached
+	m_pool.deallocate_raw_batch_thread_safe(magazine->blocks, count);
+
+	magazine->count -= count;
+	for (size_t i = 0; i < magazine->count; ++i)
+		magazine->blocks[i] = magazine->blocks[i + count];
+}
+
+void* ThreadCache::allocate_block() {
+	ThreadCacheMagazine* magazine = get_magazine();
+
+	if (magazine->count == 0) {
+		refill(magazine);
+
+		// the shared pool is exhausted as well
+		if (magazine->count == 0) return nullptr;
+	}
+
+	return magazine->blocks[--magazine->count];
+}
+
+void ThreadCache::deallocate_block(void* ptr) {
+	throw_assert(ptr != nullptr, "deallocated pointer must not be null");
+
+	ThreadCacheMagazine* magazine = get_magazine();
+
+	if (magazine->count == magazine->capacity)
+		drain(magazine, m_batchSize);
+
+	magazine->blocks[magazine->count++] = ptr;
+}
+
+void ThreadCache::flush() {
+	ThreadCacheMagazine* magazine = get_magazine();
+	drain(magazine, magazine->count);
+}